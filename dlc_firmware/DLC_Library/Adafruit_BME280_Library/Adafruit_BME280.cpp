@@ -296,6 +296,28 @@ bool Adafruit_BME280::takeForcedMeasurement(void) {
   return return_value;
 }
 
+/*!
+ *  @brief  Start a measurement in forced mode without waiting for it, collect
+ *          it later with the read functions once isMeasuring() is false
+ *  @returns true if the sensor is in forced mode and was triggered
+ */
+bool Adafruit_BME280::startForcedMeasurement(void) {
+  if (_measReg.mode != MODE_FORCED)
+    return false;
+
+  // set to forced mode, i.e. "take next measurement"
+  write8(BME280_REGISTER_CONTROL, _measReg.get());
+  return true;
+}
+
+/*!
+ *  @brief  Check whether a conversion is still running
+ *  @returns true while the sensor is measuring
+ */
+bool Adafruit_BME280::isMeasuring(void) {
+  return (read8(BME280_REGISTER_STATUS) & 0x08) != 0;
+}
+
 /*!
  *   @brief  Reads the factory-set coefficients
  */
@@ -339,9 +361,17 @@ bool Adafruit_BME280::isReadingCalibration(void) {
  *   @returns the temperature read from the device
  */
 float Adafruit_BME280::readTemperature(void) {
+  return compensateTemperature(read24(BME280_REGISTER_TEMPDATA));
+}
+
+/*!
+ *   @brief  Converts a raw temperature reading and updates t_fine
+ *   @param adc_T the 24 bit temperature register value
+ *   @returns the temperature in degrees C, NAN if the measurement is disabled
+ */
+float Adafruit_BME280::compensateTemperature(int32_t adc_T) {
   int32_t var1, var2;
 
-  int32_t adc_T = read24(BME280_REGISTER_TEMPDATA);
   if (adc_T == 0x800000) // value in case temp measurement was disabled
     return NAN;
   adc_T >>= 4;
@@ -363,11 +393,19 @@ float Adafruit_BME280::readTemperature(void) {
  *   @returns the pressure value (in Pascal) read from the device
  */
 float Adafruit_BME280::readPressure(void) {
-  int64_t var1, var2, var3, var4;
-
   readTemperature(); // must be done first to get t_fine
 
-  int32_t adc_P = read24(BME280_REGISTER_PRESSUREDATA);
+  return compensatePressure(read24(BME280_REGISTER_PRESSUREDATA));
+}
+
+/*!
+ *   @brief  Converts a raw pressure reading, t_fine must be current
+ *   @param adc_P the 24 bit pressure register value
+ *   @returns the pressure in Pascal, NAN if the measurement is disabled
+ */
+float Adafruit_BME280::compensatePressure(int32_t adc_P) {
+  int64_t var1, var2, var3, var4;
+
   if (adc_P == 0x800000) // value in case pressure measurement was disabled
     return NAN;
   adc_P >>= 4;
@@ -402,11 +440,19 @@ float Adafruit_BME280::readPressure(void) {
  *  @returns the humidity value read from the device
  */
 float Adafruit_BME280::readHumidity(void) {
-  int32_t var1, var2, var3, var4, var5;
-
   readTemperature(); // must be done first to get t_fine
 
-  int32_t adc_H = read16(BME280_REGISTER_HUMIDDATA);
+  return compensateHumidity(read16(BME280_REGISTER_HUMIDDATA));
+}
+
+/*!
+ *  @brief  Converts a raw humidity reading, t_fine must be current
+ *  @param adc_H the 16 bit humidity register value
+ *  @returns the relative humidity in %, NAN if the measurement is disabled
+ */
+float Adafruit_BME280::compensateHumidity(int32_t adc_H) {
+  int32_t var1, var2, var3, var4, var5;
+
   if (adc_H == 0x8000) // value in case humidity measurement was disabled
     return NAN;
 
@@ -429,6 +475,54 @@ float Adafruit_BME280::readHumidity(void) {
   return (float)H / 1024.0;
 }
 
+/*!
+ *   @brief  Reads temperature, pressure and humidity in one burst of the
+ *           data registers (0xF7-0xFE) so all three come from the same
+ *           measurement and t_fine is computed once
+ *   @param temperature set to degrees C, may be NULL
+ *   @param pressure set to Pascal, may be NULL to skip the 64 bit math
+ *   @param humidity set to relative humidity in %, may be NULL
+ *   @returns true if every requested value is valid
+ */
+bool Adafruit_BME280::readAll(float *temperature, float *pressure,
+                              float *humidity) {
+  uint8_t buffer[8];
+
+  if (i2c_dev) {
+    buffer[0] = uint8_t(BME280_REGISTER_PRESSUREDATA);
+    if (!i2c_dev->write_then_read(buffer, 1, buffer, 8))
+      return false;
+  } else {
+    buffer[0] = uint8_t(BME280_REGISTER_PRESSUREDATA | 0x80);
+    if (!spi_dev->write_then_read(buffer, 1, buffer, 8))
+      return false;
+  }
+
+  int32_t adc_P = uint32_t(buffer[0]) << 16 | uint32_t(buffer[1]) << 8 |
+                  uint32_t(buffer[2]);
+  int32_t adc_T = uint32_t(buffer[3]) << 16 | uint32_t(buffer[4]) << 8 |
+                  uint32_t(buffer[5]);
+  int32_t adc_H = uint16_t(buffer[6]) << 8 | uint16_t(buffer[7]);
+
+  // temperature always runs, the others need its t_fine
+  float T = compensateTemperature(adc_T);
+  if (isnan(T))
+    return false;
+
+  bool valid = true;
+  if (temperature)
+    *temperature = T;
+  if (pressure) {
+    *pressure = compensatePressure(adc_P);
+    valid &= !isnan(*pressure);
+  }
+  if (humidity) {
+    *humidity = compensateHumidity(adc_H);
+    valid &= !isnan(*humidity);
+  }
+  return valid;
+}
+
 /*!
  *   Calculates the altitude (in meters) from the specified atmospheric
  *   pressure (in hPa), and sea-level pressure (in hPa).
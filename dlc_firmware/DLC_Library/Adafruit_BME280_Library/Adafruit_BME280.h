@@ -226,9 +226,12 @@ public:
                    standby_duration duration = STANDBY_MS_0_5);
 
   bool takeForcedMeasurement(void);
+  bool startForcedMeasurement(void);
+  bool isMeasuring(void);
   float readTemperature(void);
   float readPressure(void);
   float readHumidity(void);
+  bool readAll(float *temperature, float *pressure, float *humidity);
 
   float readAltitude(float seaLevel);
   float seaLevelForAltitude(float altitude, float pressure);
@@ -265,6 +268,10 @@ protected:
   uint16_t read16_LE(byte reg); // little endian
   int16_t readS16_LE(byte reg); // little endian
 
+  float compensateTemperature(int32_t adc_T);
+  float compensatePressure(int32_t adc_P);
+  float compensateHumidity(int32_t adc_H);
+
   uint8_t _i2caddr;  //!< I2C addr for the TwoWire interface
   int32_t _sensorID; //!< ID of the BME Sensor
   int32_t t_fine; //!< temperature with high resolution, stored as an attribute
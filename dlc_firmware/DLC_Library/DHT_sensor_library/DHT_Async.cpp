@@ -0,0 +1,210 @@
+/*!
+ *  @file DHT_Async.cpp
+ *
+ *  Interrupt-captured DHT22 reader for the DHT sensor library.
+ *
+ *  A frame is the sensor's 80 us low/high response followed by 40 bits, each
+ *  a 50 us low and a 26-28 us (0) or 70 us (1) high. The pin-change interrupt
+ *  stores the width of the level each edge ends together with the level the
+ *  edge leads to, update() decodes the high widths once the frame is over.
+ *
+ *  MIT license, all text above must be included in any redistribution
+ */
+
+#include "DHT_Async.h"
+
+#define DHT_ASYNC_MIN_INTERVAL                                                  \
+  1900 /**< the sensor needs ~2 s between reads, a little under lets a 2 s   \
+            caller schedule hit every slot */
+#define DHT_ASYNC_START_MS 2    /**< start signal, >= 1 ms with millis() jitter */
+#define DHT_ASYNC_FRAME_MS 10   /**< response and 40 bits are done by then */
+#define DHT_ASYNC_ONE_US 48     /**< highs longer than this are 1 bits */
+#define DHT_ASYNC_LEVEL 0x80    /**< edge byte flag, line is high after the edge */
+#define DHT_ASYNC_WIDTH 0x7F    /**< edge byte mask, width in us (saturating) */
+
+#if defined(__AVR__)
+static DHT_Async *captureInstance = NULL; /**< receives the pin-change edges */
+
+ISR(DHT_ASYNC_PCINT_VECTOR) {
+  if (captureInstance) {
+    captureInstance->handleEdge();
+  }
+}
+#endif
+
+/*!
+ *  @brief  Instantiates a new DHT_Async class
+ *  @param  pin
+ *          pin number that sensor is connected
+ */
+DHT_Async::DHT_Async(uint8_t pin) {
+  _pin = pin;
+  _bit = digitalPinToBitMask(pin);
+  _inputReg = portInputRegister(digitalPinToPort(pin));
+  _pcmsk = NULL;
+  _pcmskBit = 0;
+  _pcicrBit = 0;
+  _state = IDLE;
+  _stateMillis = 0;
+  _lastReadMillis = 0;
+  _valid = false;
+  _temperature = NAN;
+  _humidity = NAN;
+  _edgeCount = 0;
+  _lastEdgeMicros = 0;
+}
+
+/*!
+ *  @brief  Setup sensor pin and pin-change interrupt
+ *  @return true if the pin has a pin-change interrupt to capture with
+ */
+bool DHT_Async::begin() {
+  pinMode(_pin, INPUT_PULLUP);
+  // first read doesn't have to wait out the interval
+  _lastReadMillis = millis() - DHT_ASYNC_MIN_INTERVAL;
+
+#if defined(__AVR__)
+  _pcmsk = digitalPinToPCMSK(_pin);
+  if (_pcmsk == NULL) {
+    return false;
+  }
+  _pcmskBit = digitalPinToPCMSKbit(_pin);
+  _pcicrBit = digitalPinToPCICRbit(_pin);
+  captureInstance = this;
+  return true;
+#else
+  return false;
+#endif
+}
+
+/*!
+ *  @brief  Pull the line low to wake the sensor, update() releases it
+ *  @return true if a read was started, false if one is running, the sensor
+ *          was read too recently or begin() failed
+ */
+bool DHT_Async::startRead() {
+  if (_pcmsk == NULL || _state != IDLE ||
+      millis() - _lastReadMillis < DHT_ASYNC_MIN_INTERVAL) {
+    return false;
+  }
+
+  pinMode(_pin, OUTPUT);
+  digitalWrite(_pin, LOW);
+  _stateMillis = millis();
+  _lastReadMillis = _stateMillis;
+  _state = START_SIGNAL;
+  return true;
+}
+
+/*!
+ *  @brief  Advance a running read, call every loop
+ */
+void DHT_Async::update() {
+#if defined(__AVR__)
+  switch (_state) {
+  case START_SIGNAL:
+    if (millis() - _stateMillis < DHT_ASYNC_START_MS) {
+      return;
+    }
+    _edgeCount = 0;
+    _lastEdgeMicros = micros();
+
+    // release the line and only then listen, so the release isn't captured
+    pinMode(_pin, INPUT_PULLUP);
+    PCIFR = _BV(_pcicrBit);
+    *_pcmsk |= _BV(_pcmskBit);
+    PCICR |= _BV(_pcicrBit);
+
+    _stateMillis = millis();
+    _state = CAPTURING;
+    break;
+
+  case CAPTURING:
+    if (millis() - _stateMillis < DHT_ASYNC_FRAME_MS) {
+      return;
+    }
+    // other pins in the group may still need the group enabled
+    *_pcmsk &= ~_BV(_pcmskBit);
+
+    _valid = decode();
+    _state = IDLE;
+    break;
+
+  default:
+    break;
+  }
+#endif
+}
+
+/*!
+ *  @brief  Check if a read is in progress
+ *  @return true until the started frame has been decoded
+ */
+bool DHT_Async::isBusy() { return _state != IDLE; }
+
+/*!
+ *  @brief  Get the values of the last decoded frame
+ *  @param  temperature
+ *          set to the temperature in Celsius, NAN if the frame was bad
+ *  @param  humidity
+ *          set to the relative humidity in percent, NAN if the frame was bad
+ *  @return true if the last frame decoded and passed its checksum
+ */
+bool DHT_Async::getReading(float &temperature, float &humidity) {
+  temperature = _temperature;
+  humidity = _humidity;
+  return _valid;
+}
+
+/*!
+ *  @brief  Timestamp one edge, called from the pin-change interrupt
+ */
+void DHT_Async::handleEdge() {
+  uint8_t level = (*_inputReg & _bit) ? DHT_ASYNC_LEVEL : 0;
+  uint32_t now = micros();
+  uint32_t width = now - _lastEdgeMicros;
+  _lastEdgeMicros = now;
+
+  if (_edgeCount < DHT_ASYNC_MAX_EDGES) {
+    _edges[_edgeCount++] =
+        level | (width > DHT_ASYNC_WIDTH ? DHT_ASYNC_WIDTH : width);
+  }
+}
+
+/*!
+ *  @brief  Turn the captured edges into a reading
+ *  @return true if 40 bits were found and the checksum matched
+ */
+bool DHT_Async::decode() {
+  uint8_t data[5] = {0, 0, 0, 0, 0};
+  uint8_t bits = 0;
+
+  _temperature = NAN;
+  _humidity = NAN;
+
+  // a falling edge ends a high, the last 40 highs are the data bits; walking
+  // back from the end skips anything picked up before the response
+  for (int8_t i = _edgeCount - 1; i >= 0 && bits < 40; i--) {
+    uint8_t edge = _edges[i];
+    if (edge & DHT_ASYNC_LEVEL) {
+      continue;
+    }
+    uint8_t position = 39 - bits;
+    if ((edge & DHT_ASYNC_WIDTH) > DHT_ASYNC_ONE_US) {
+      data[position / 8] |= 0x80 >> (position % 8);
+    }
+    bits++;
+  }
+
+  if (bits < 40 ||
+      data[4] != ((data[0] + data[1] + data[2] + data[3]) & 0xFF)) {
+    return false;
+  }
+
+  _humidity = ((word)data[0] << 8 | data[1]) * 0.1;
+  _temperature = ((word)(data[2] & 0x7F) << 8 | data[3]) * 0.1;
+  if (data[2] & 0x80) {
+    _temperature = -_temperature;
+  }
+  return true;
+}
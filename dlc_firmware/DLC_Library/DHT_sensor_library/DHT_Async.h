@@ -0,0 +1,66 @@
+/*!
+ *  @file DHT_Async.h
+ *
+ *  Interrupt-captured DHT22 reader for the DHT sensor library.
+ *
+ *  DHT::read() holds interrupts off for the whole ~5 ms frame and busy-waits
+ *  on every pulse. This reader lets a pin-change interrupt timestamp each
+ *  edge of the frame instead and decodes the captured pulse widths from the
+ *  main loop, so interrupts stay enabled and the caller never blocks.
+ *
+ *  Only one instance can capture at a time. The pin must have a pin-change
+ *  interrupt in the group served by DHT_ASYNC_PCINT_VECTOR (pins 8-13 on an
+ *  ATmega328P by default).
+ *
+ *  MIT license, all text above must be included in any redistribution
+ */
+
+#ifndef DHT_ASYNC_H
+#define DHT_ASYNC_H
+
+#include "Arduino.h"
+
+#ifndef DHT_ASYNC_PCINT_VECTOR
+#define DHT_ASYNC_PCINT_VECTOR                                                  \
+  PCINT0_vect /**< pin-change group the sensor pin belongs to */
+#endif
+
+#define DHT_ASYNC_MAX_EDGES 90 /**< a full frame is 84 edges, plus slack */
+
+/*!
+ *  @brief  Class that reads a DHT22 without blocking
+ */
+class DHT_Async {
+public:
+  /*! Reader states, IDLE once a frame has been decoded */
+  enum State { IDLE, START_SIGNAL, CAPTURING };
+
+  DHT_Async(uint8_t pin);
+  bool begin();
+  bool startRead();
+  void update();
+  bool isBusy();
+  bool getReading(float &temperature, float &humidity);
+  void handleEdge();
+
+private:
+  bool decode();
+
+  uint8_t _pin;
+  uint8_t _bit;
+  volatile uint8_t *_inputReg;
+  volatile uint8_t *_pcmsk;
+  uint8_t _pcmskBit, _pcicrBit;
+  State _state;
+  uint32_t _stateMillis;
+  uint32_t _lastReadMillis;
+  bool _valid;
+  float _temperature, _humidity;
+
+  //written by the interrupt while capturing
+  volatile uint8_t _edges[DHT_ASYNC_MAX_EDGES];
+  volatile uint8_t _edgeCount;
+  volatile uint32_t _lastEdgeMicros;
+};
+
+#endif
@@ -172,13 +172,23 @@ bool DallasTemperature::isConnected(const uint8_t* deviceAddress) {
 // also allows for updating the read scratchpad
 bool DallasTemperature::isConnected(const uint8_t* deviceAddress,
 		uint8_t* scratchPad) {
-	bool b = readScratchPad(deviceAddress, scratchPad);
-	return b && !isAllZeros(scratchPad) && (_wire->crc8(scratchPad, 8) == scratchPad[SCRATCHPAD_CRC]);
+	uint8_t crc;
+	bool b = readScratchPad(deviceAddress, scratchPad, crc);
+	return b && !isAllZeros(scratchPad) && (crc == 0);
 }
 
 bool DallasTemperature::readScratchPad(const uint8_t* deviceAddress,
 		uint8_t* scratchPad) {
 
+	uint8_t crc;
+	return readScratchPad(deviceAddress, scratchPad, crc);
+}
+
+// the CRC runs over all 9 bytes as they're read, including the CRC byte
+// itself, which leaves 0 for an intact scratchpad
+bool DallasTemperature::readScratchPad(const uint8_t* deviceAddress,
+		uint8_t* scratchPad, uint8_t& crc) {
+
 	// send the reset command and fail fast
 	int b = _wire->reset();
 	if (b == 0)
@@ -187,7 +197,7 @@ bool DallasTemperature::readScratchPad(const uint8_t* deviceAddress,
 	_wire->select(deviceAddress);
 	_wire->write(READSCRATCH);
 
-	// Read all registers in a simple loop
+	// Read all registers, adding each to the CRC as it arrives
 	// byte 0: temperature LSB
 	// byte 1: temperature MSB
 	// byte 2: high alarm temp
@@ -200,9 +210,7 @@ bool DallasTemperature::readScratchPad(const uint8_t* deviceAddress,
 	// byte 7: DS18S20: COUNT_PER_C
 	//         DS18B20 & DS1822: store for crc
 	// byte 8: SCRATCHPAD_CRC
-	for (uint8_t i = 0; i < 9; i++) {
-		scratchPad[i] = _wire->read();
-	}
+	crc = _wire->read_bytes_crc8(scratchPad, 9);
 
 	b = _wire->reset();
 	return (b == 1);
@@ -294,6 +294,9 @@ private:
 
 	void blockTillConversionComplete(uint8_t);
 
+	// reads the scratchpad, crc is 0 if it arrived intact
+	bool readScratchPad(const uint8_t*, uint8_t*, uint8_t& crc);
+
 	// Returns true if all bytes of scratchPad are '\0'
 	bool isAllZeros(const uint8_t* const scratchPad, const size_t length = 9);
 
@@ -68,9 +68,22 @@ void EEPROMWearLevel::init(const byte layoutVersion) {
 		}
 
 		eepromConfig[index].lastIndexRead = findIndex(eepromConfig[index], controlBytesCount);
+		eepromConfig[index].writeCount = 0;
+		eepromConfig[index].wrapCount = 0;
+#ifndef NO_RAM_SHADOW
+		// filled on the first get() or put()
+		eepromConfig[index].shadow = NULL;
+		eepromConfig[index].shadowLength = 0;
+#endif
 	}
 	// the last one as a placeholder to calculate the length of the last real element
 	eepromConfig[index].lastIndexRead = NO_DATA;
+	eepromConfig[index].writeCount = 0;
+	eepromConfig[index].wrapCount = 0;
+#ifndef NO_RAM_SHADOW
+	eepromConfig[index].shadow = NULL;
+	eepromConfig[index].shadowLength = 0;
+#endif
 
 	// prevent warning about not using EEPROM
 	(void)EEPROM;
@@ -132,6 +145,26 @@ int EEPROMWearLevel::getCurrentIndexEEPROM(const int idx, int dataLength) {
 	return eepromConfig[idx].lastIndexRead + 1 - dataLength;
 }
 
+unsigned long EEPROMWearLevel::getWriteCount(const int idx) const {
+#ifndef NO_RANGE_CHECK
+	if (idx >= amountOfIndexes) {
+		logOutOfRange(idx);
+		return 0;
+	}
+#endif
+	return eepromConfig[idx].writeCount;
+}
+
+unsigned long EEPROMWearLevel::getWrapCount(const int idx) const {
+#ifndef NO_RANGE_CHECK
+	if (idx >= amountOfIndexes) {
+		logOutOfRange(idx);
+		return 0;
+	}
+#endif
+	return eepromConfig[idx].wrapCount;
+}
+
 int EEPROMWearLevel::getWriteStartIndex(const int idx, const int dataLength, const byte *values, const bool update, const int controlBytesCount) {
 	if (dataLength > getMaxDataLength(idx)) {
 #ifdef DEBUG_LOG
@@ -178,6 +211,7 @@ int EEPROMWearLevel::getWriteStartIndex(const int idx, const int dataLength, con
 		Serial.println(F("all used, start again"));
 #endif
 		clearBytesToOnes(config.startIndexControlBytes, controlBytesCount);
+		config.wrapCount++;
 		newStartIndex = config.startIndexControlBytes + controlBytesCount;
 	}
 	return newStartIndex;
@@ -187,6 +221,7 @@ void EEPROMWearLevel::updateControlBytes(int idx, int newStartIndex, int dataLen
 	EEPROMConfig &config = eepromConfig[idx];
 	// -1 because it is the last index
 	config.lastIndexRead = newStartIndex + dataLength - 1;
+	config.writeCount++;
 	const int startIndexData = config.startIndexControlBytes + controlBytesCount;
 	const int startIndexRelative = newStartIndex - startIndexData;
 	int controlByteIndex = startIndexRelative / 8;
@@ -210,6 +245,26 @@ void EEPROMWearLevel::updateControlBytes(int idx, int newStartIndex, int dataLen
 	}
 }
 
+#ifndef NO_RAM_SHADOW
+void EEPROMWearLevel::updateShadow(const int idx, const byte *values, const int dataLength) {
+	EEPROMConfig &config = eepromConfig[idx];
+	if (config.shadowLength != dataLength) {
+		// first access or the index is used with an other type
+		byte *shadow = dataLength <= 0xFF ? (byte*) realloc(config.shadow, dataLength) : NULL;
+		if (shadow == NULL) {
+			// out of RAM or too long, keep comparing in EEPROM
+			free(config.shadow);
+			config.shadow = NULL;
+			config.shadowLength = 0;
+			return;
+		}
+		config.shadow = shadow;
+		config.shadowLength = dataLength;
+	}
+	memcpy(config.shadow, values, dataLength);
+}
+#endif
+
 void EEPROMWearLevel::printStatus(Print &print) {
 	print.println(F("EEPROMWearLevel status: "));
 	for (int index = 0; index < amountOfIndexes; index++) {
@@ -222,7 +277,12 @@ void EEPROMWearLevel::printStatus(Print &print) {
 		print.print(F(" with "));
 		print.print(controlBytesCount);
 		print.print(F(" ctrl bytes at "));
-		print.println(eepromConfig[index].lastIndexRead);
+		print.print(eepromConfig[index].lastIndexRead);
+		print.print(F(", "));
+		print.print(eepromConfig[index].writeCount);
+		print.print(F(" writes, "));
+		print.print(eepromConfig[index].wrapCount);
+		print.println(F(" wraps"));
 	}
 }
 
@@ -411,7 +471,10 @@ void EEPROMWearLevel::programZeroBitsToZero(int index, byte byteWithZeros) {
 #endif
 
 void EEPROMWearLevel::clearBytesToOnes(int fromIndex, int length) {
-	for (int i = fromIndex; i < fromIndex + length; i++) {
+	// last byte first, a reset part way through then still leaves the
+	// used (0) control bytes before the unused (0xFF) ones, as the binary
+	// search in findControlByteIndex() expects
+	for (int i = fromIndex + length - 1; i >= fromIndex; i--) {
 		if (readByte(i) != 0xFF) {
 #ifndef NO_EEPROM_WRITES
 			clearByteToOnes(i);
@@ -30,6 +30,11 @@
    uncomment to use an array instead of the real EEPROM for testing purpose
 */
 //#define NO_EEPROM_WRITES
+/**
+   uncomment to always compare against and read from the EEPROM instead of the
+   RAM copy of each index's current value
+*/
+//#define NO_RAM_SHADOW
 /**
    uncomment to write debug logs to Serial
 */
@@ -154,6 +159,18 @@ class EEPROMWearLevel: EEPROMClass {
     */
     int getCurrentIndexEEPROM(const int idx, int dataLength) ;
 
+    /**
+       returns how many values were written to idx since begin().
+    */
+    unsigned long getWriteCount(const int idx) const;
+
+    /**
+       returns how many times all data bytes of idx were used up and its
+       control bytes cleared to start again on the first one since begin().
+       Every data byte of idx is written about once per wrap around.
+    */
+    unsigned long getWrapCount(const int idx) const;
+
     /**
        prints the EEPROMWearLevel status to print. Use Serial to
        print to the default serial port.
@@ -185,6 +202,26 @@ class EEPROMWearLevel: EEPROMClass {
            NO_DATA (-1) for no data
         */
         int lastIndexRead;
+        /**
+           values written since begin()
+        */
+        unsigned long writeCount;
+        /**
+           control byte clears since begin()
+        */
+        unsigned long wrapCount;
+#ifndef NO_RAM_SHADOW
+        /**
+           RAM copy of the current value, allocated on the first get() or
+           put() of this index. Only valid if shadowLength matches the
+           length of the data being compared.
+        */
+        byte *shadow;
+        /**
+           the length of shadow, 0 if the current value is not known
+        */
+        byte shadowLength;
+#endif
     };
 
     EEPROMConfig *eepromConfig;
@@ -238,7 +275,8 @@ class EEPROMWearLevel: EEPROMClass {
     */
     void programZeroBitsToZero(int index, byte byteWithZeros);
     /*
-       set all bits in all given bytes to one with an erase operation.
+       set all bits in all given bytes to one with an erase operation,
+       starting with the last byte.
     */
     void clearBytesToOnes(int startIndex, int length);
     /**
@@ -256,6 +294,19 @@ class EEPROMWearLevel: EEPROMClass {
     */
     void logOutOfRange(int idx) const;
 
+#ifndef NO_RAM_SHADOW
+    /**
+       returns true if the RAM copy of idx holds a value of dataLength bytes.
+    */
+    inline bool hasShadow(const int idx, const int dataLength) const {
+      return eepromConfig[idx].shadowLength == dataLength;
+    }
+    /**
+       copy the value just written to or read from idx into its RAM copy.
+    */
+    void updateShadow(const int idx, const byte *values, const int dataLength);
+#endif
+
     // --------------------------------------------------------
     // implementation of template methods
     // --------------------------------------------------------
@@ -269,6 +320,12 @@ class EEPROMWearLevel: EEPROMClass {
       const int lastIndex = eepromConfig[idx].lastIndexRead;
       if (lastIndex != NO_DATA) {
         const int dataLength = sizeof(t);
+#ifndef NO_RAM_SHADOW
+        if (hasShadow(idx, dataLength)) {
+          memcpy((byte*) &t, eepromConfig[idx].shadow, dataLength);
+          return t;
+        }
+#endif
         // +1 because it is the last index
         const int firstIndex = lastIndex + 1 - dataLength;
 #ifndef NO_EEPROM_WRITES
@@ -278,6 +335,9 @@ class EEPROMWearLevel: EEPROMClass {
         for (int i = 0; i < dataLength; i++) {
           values[i] = fakeEeprom[firstIndex + i];
         }
+#endif
+#ifndef NO_RAM_SHADOW
+        updateShadow(idx, (const byte*) &t, dataLength);
 #endif
       } else {
 #ifdef DEBUG_LOG
@@ -300,9 +360,21 @@ class EEPROMWearLevel: EEPROMClass {
 #endif
       const int dataLength = sizeof(t);
       const byte *values = (const byte*) &t;
+#ifndef NO_RAM_SHADOW
+      bool compareInEEPROM = update;
+      if (update && hasShadow(idx, dataLength)) {
+        if (memcmp(eepromConfig[idx].shadow, values, dataLength) == 0) {
+          // equal to the current value, nothing to read or write
+          return t;
+        }
+        compareInEEPROM = false;
+      }
+#else
+      const bool compareInEEPROM = update;
+#endif
       const int controlBytesCount = getControlBytesCount(idx);
 
-      const int writeStartIndex = getWriteStartIndex(idx, dataLength, values, update, controlBytesCount);
+      const int writeStartIndex = getWriteStartIndex(idx, dataLength, values, compareInEEPROM, controlBytesCount);
       if (writeStartIndex < 0) {
         return t;
       }
@@ -314,6 +386,9 @@ class EEPROMWearLevel: EEPROMClass {
       }
 #endif
       updateControlBytes(idx, writeStartIndex, dataLength, controlBytesCount);
+#ifndef NO_RAM_SHADOW
+      updateShadow(idx, values, dataLength);
+#endif
       return t;
     }
 };
@@ -167,6 +167,9 @@ void OneWire::begin(uint8_t pin)
 #if ONEWIRE_SEARCH
 	reset_search();
 #endif
+#if ONEWIRE_FRAMES
+	frameStatus = ONEWIRE_FRAME_IDLE;
+#endif
 }
 
 
@@ -176,7 +179,16 @@ void OneWire::begin(uint8_t pin)
 //
 // Returns 1 if a device asserted a presence pulse, 0 otherwise.
 //
-uint8_t CRIT_TIMING OneWire::reset(void)
+uint8_t OneWire::reset(void)
+{
+#if ONEWIRE_FRAMES
+	// the frame can't carry on after the bus was reset under it
+	if (frameStatus == ONEWIRE_FRAME_BUSY) frameStatus = ONEWIRE_FRAME_ABORTED;
+#endif
+	return reset_pulse();
+}
+
+uint8_t CRIT_TIMING OneWire::reset_pulse(void)
 {
 	IO_REG_TYPE mask IO_REG_MASK_ATTR = bitmask;
 	__attribute__((unused)) volatile IO_REG_TYPE *reg IO_REG_BASE_ATTR = baseReg;
@@ -306,6 +318,57 @@ void OneWire::read_bytes(uint8_t *buf, uint16_t count) {
     buf[i] = read();
 }
 
+#if ONEWIRE_FRAMES
+//
+// Frames.  Each poll sends one piece with the blocking bit slots, so the
+// timing is exactly that of reset(), write() and read().  The bus idles
+// high between pieces for as long as the sketch takes, which 1-Wire allows.
+//
+bool OneWire::start_frame(const uint8_t *tx, uint8_t txCount, uint8_t *rx, uint8_t rxCount)
+{
+	if (frameStatus == ONEWIRE_FRAME_BUSY) return false;
+
+	frameTx = tx;
+	frameTxCount = txCount;
+	frameRx = rx;
+	frameRxCount = rxCount;
+	framePiece = 0;
+	frameStatus = ONEWIRE_FRAME_BUSY;
+	return true;
+}
+
+uint8_t OneWire::frame_poll(void)
+{
+	if (frameStatus != ONEWIRE_FRAME_BUSY) return frameStatus;
+
+	if (framePiece == 0) {
+		if (!reset_pulse()) {
+			frameStatus = ONEWIRE_FRAME_NO_DEVICE;
+			return frameStatus;
+		}
+	} else if (framePiece <= frameTxCount) {
+		write(frameTx[framePiece - 1]);
+	} else {
+		frameRx[framePiece - 1 - frameTxCount] = read();
+	}
+
+	if (++framePiece > frameTxCount + frameRxCount) {
+		frameStatus = ONEWIRE_FRAME_DONE;
+	}
+	return frameStatus;
+}
+#endif
+
+#if ONEWIRE_CRC
+uint8_t OneWire::read_bytes_crc8(uint8_t *buf, uint16_t count, uint8_t crc /* = 0 */) {
+  for (uint16_t i = 0 ; i < count ; i++) {
+    buf[i] = read();
+    crc = crc8_update(crc, buf[i]);
+  }
+  return crc;
+}
+#endif
+
 //
 // Do a ROM select
 //
@@ -515,45 +578,47 @@ static const uint8_t PROGMEM dscrc2x16_table[] = {
 	0x8C, 0x11, 0xAF, 0x32, 0xCA, 0x57, 0xE9, 0x74
 };
 
-// Compute a Dallas Semiconductor 8 bit CRC. These show up in the ROM
-// and the registers.  (Use tiny 2x16 entry CRC table)
-uint8_t OneWire::crc8(const uint8_t *addr, uint8_t len)
+// Add one byte to a running Dallas Semiconductor 8 bit CRC, one lookup
+// per nibble.  (Use tiny 2x16 entry CRC table)
+uint8_t OneWire::crc8_update(uint8_t crc, uint8_t data)
 {
-	uint8_t crc = 0;
-
-	while (len--) {
-		crc = *addr++ ^ crc;  // just re-using crc as intermediate
-		crc = pgm_read_byte(dscrc2x16_table + (crc & 0x0f)) ^
+	crc = data ^ crc;  // just re-using crc as intermediate
+	return pgm_read_byte(dscrc2x16_table + (crc & 0x0f)) ^
 		pgm_read_byte(dscrc2x16_table + 16 + ((crc >> 4) & 0x0f));
-	}
-
-	return crc;
 }
 #else
 //
-// Compute a Dallas Semiconductor 8 bit CRC directly.
+// Add one byte to a running Dallas Semiconductor 8 bit CRC directly.
 // this is much slower, but a little smaller, than the lookup table.
 //
+uint8_t OneWire::crc8_update(uint8_t crc, uint8_t data)
+{
+#if defined(__AVR__)
+	return _crc_ibutton_update(crc, data);
+#else
+	for (uint8_t i = 8; i; i--) {
+		uint8_t mix = (crc ^ data) & 0x01;
+		crc >>= 1;
+		if (mix) crc ^= 0x8C;
+		data >>= 1;
+	}
+	return crc;
+#endif
+}
+#endif
+
+// Compute a Dallas Semiconductor 8 bit CRC. These show up in the ROM
+// and the registers.
 uint8_t OneWire::crc8(const uint8_t *addr, uint8_t len)
 {
 	uint8_t crc = 0;
 
 	while (len--) {
-#if defined(__AVR__)
-		crc = _crc_ibutton_update(crc, *addr++);
-#else
-		uint8_t inbyte = *addr++;
-		for (uint8_t i = 8; i; i--) {
-			uint8_t mix = (crc ^ inbyte) & 0x01;
-			crc >>= 1;
-			if (mix) crc ^= 0x8C;
-			inbyte >>= 1;
-		}
-#endif
+		crc = crc8_update(crc, *addr++);
 	}
+
 	return crc;
 }
-#endif
 
 #if ONEWIRE_CRC16
 bool OneWire::check_crc16(const uint8_t* input, uint16_t len, const uint8_t* inverted_crc, uint16_t crc)
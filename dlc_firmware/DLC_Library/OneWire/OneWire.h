@@ -51,6 +51,21 @@
 #define ONEWIRE_CRC16 1
 #endif
 
+// Run whole frames (reset, write bytes, read bytes) a piece at a time from
+// the sketch's loop instead of in one blocking call.  Each frame_poll()
+// does the reset or one byte with the same bit slots as the blocking
+// calls, interrupts are only off inside each slot.  No timer or interrupt
+// is taken.  You can exclude frames by defining this to 0.
+#ifndef ONEWIRE_FRAMES
+#define ONEWIRE_FRAMES 1
+#endif
+
+#define ONEWIRE_FRAME_IDLE 0       // no frame run yet
+#define ONEWIRE_FRAME_BUSY 1       // frame still on the bus
+#define ONEWIRE_FRAME_DONE 2       // all bytes sent and received
+#define ONEWIRE_FRAME_NO_DEVICE 3  // no presence pulse, or the bus is held low
+#define ONEWIRE_FRAME_ABORTED 4    // a blocking reset() took the bus part-way through
+
 // Board-specific macros for direct GPIO
 #include "util/OneWire_direct_regtype.h"
 
@@ -68,6 +83,19 @@ class OneWire
     bool LastDeviceFlag;
 #endif
 
+#if ONEWIRE_FRAMES
+    // frame state, advanced by frame_poll()
+    const uint8_t *frameTx;
+    uint8_t *frameRx;
+    uint8_t frameTxCount;
+    uint8_t frameRxCount;
+    uint16_t framePiece;  // 0 is the reset, then each byte written and read
+    uint8_t frameStatus;
+#endif
+
+    // The reset pulse and presence check behind reset() and frames.
+    uint8_t reset_pulse(void);
+
   public:
     OneWire() { }
     OneWire(uint8_t pin) { begin(pin); }
@@ -76,6 +104,7 @@ class OneWire
     // Perform a 1-Wire reset cycle. Returns 1 if a device responds
     // with a presence pulse.  Returns 0 if there is no device or the
     // bus is shorted or otherwise held low for more than 250uS
+    // A frame still running on this bus ends as ONEWIRE_FRAME_ABORTED.
     uint8_t reset(void);
 
     // Issue a 1-Wire rom select command, you do the reset first.
@@ -97,6 +126,31 @@ class OneWire
 
     void read_bytes(uint8_t *buf, uint16_t count);
 
+#if ONEWIRE_FRAMES
+    // Start a reset followed by writing txCount bytes and reading rxCount
+    // bytes into rx, then return straight away.  Both buffers must stay
+    // valid until the frame is over.  Returns false if this bus is
+    // already running a frame.  Nothing is sent until frame_poll().
+    bool start_frame(const uint8_t *tx, uint8_t txCount, uint8_t *rx, uint8_t rxCount);
+
+    // Send the next piece of the frame, the reset (about 1ms) or one
+    // byte (about 0.6ms), and return the frame status.  Call it until
+    // it stops returning ONEWIRE_FRAME_BUSY, the bus may idle for as
+    // long as needed in between.
+    uint8_t frame_poll(void);
+
+    // ONEWIRE_FRAME_BUSY until the frame started on this bus is over.
+    uint8_t frame_status(void) { return frameStatus; }
+#endif
+
+#if ONEWIRE_CRC
+    // Read bytes and return their 8 bit CRC, each byte is added while the
+    // bus is idle between bytes instead of in a second pass afterwards.
+    // Reading a block that ends with its own CRC byte returns 0 when the
+    // block is intact.
+    uint8_t read_bytes_crc8(uint8_t *buf, uint16_t count, uint8_t crc = 0);
+#endif
+
     // Write a bit. The bus is always left powered at the end, see
     // note in write() about that.
     void write_bit(uint8_t v);
@@ -133,6 +187,9 @@ class OneWire
     // ROM and scratchpad registers.
     static uint8_t crc8(const uint8_t *addr, uint8_t len);
 
+    // Add one byte to a running 8 bit CRC.
+    static uint8_t crc8_update(uint8_t crc, uint8_t data);
+
 #if ONEWIRE_CRC16
     // Compute the 1-Wire CRC16 and compare it against the received CRC.
     // Example usage (reading a DS2408):
@@ -0,0 +1,86 @@
+/*******************************************************************
+Creative Commons Attribution-NonCommercial License
+
+Copyright © 2020-2025 Nathan Woelfle
+
+This work is licensed under a Creative Commons Attribution-NonCommercial 4.0 International License.
+
+You are free to:
+
+    Share — copy and redistribute the material in any medium or format
+    Adapt — remix, transform, and build upon the material
+
+Under the following conditions:
+
+    Attribution — You must give appropriate credit, provide a link to the license, and indicate if changes were made. You may do so in any reasonable manner, but not in any way that suggests the licensor endorses you or your use.
+    NonCommercial — You may not use the material for commercial purposes.
+    No additional restrictions — You may not apply legal terms or technological measures that legally restrict others from doing anything the license permits.
+
+Notices:
+
+    You may not use this work for commercial purposes without written permission from the copyright holder.
+    This work is provided "as is" without warranty of any kind, either express or implied, including but not limited to the warranties of merchantability, fitness for a particular purpose, and noninfringement. In no event shall the authors or copyright holders be liable for any claim, damages, or other liability, whether in an action of contract, tort, or otherwise, arising from, out of, or in connection with the software or the use or other dealings in the software.
+
+Scope:
+
+    This license applies to both the hardware and software components of the DarkLight Cover Calibrator.
+
+Modified Versions:
+
+    You are permitted to create modified versions of the DarkLight Cover Calibrator for non-commercial use, provided that you:
+        Retain the original copyright notice and license terms.
+        Include a clear reference to the original creator (Nathan Woelfle) and provide a link to the original work.
+
+Jurisdiction:
+
+    This license is governed by the laws of the United States of America, and by international copyright laws and treaties.
+
+For more information, please refer to the full terms of the Creative Commons Attribution-NonCommercial 4.0 International License: https://creativecommons.org/licenses/by-nc/4.0/
+*******************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+
+//August-Roche-Magnus dew point in fixed point for the heater controller
+//kept out of the sketch so the host test (dlc_dewpoint_test) checks this same code against the float formula
+
+//dew point constants - DO NOT MODIFY
+const int32_t DEW_POINT_ALPHA = 70738;  // August-Roche-Magnus dew point constant, 17.27 as Q12
+const int32_t DEW_POINT_BETA = 23770;   // August-Roche-Magnus dew point constant, 237.7 in centi-degrees
+const int32_t LN2_Q16 = 45426;          // ln(2) as Q16
+const int32_t LN10000_Q16 = 603609;     // ln(10000) as Q16, humidity is in hundredths of a percent
+//ln(1 + i/32) as Q16, mantissa of the humidity after normalizing it to [1, 2)
+const uint16_t lnMantissa[33] PROGMEM = {
+      0,  2017,  3973,  5873,  7719,  9515, 11262, 12965,
+  14624, 16242, 17821, 19364, 20870, 22343, 23783, 25193,
+  26573, 27924, 29248, 30546, 31818, 33067, 34292, 35494,
+  36675, 37835, 38975, 40095, 41196, 42280, 43345, 44394,
+  45426
+};
+
+//August-Roche-Magnus dew point in fixed point, temperatures in centi-degrees and humidity in hundredths of a percent
+inline int16_t calculateDewPoint(int16_t temp, uint16_t humidity) {
+  //ln of 0% is undefined, the driest reading is treated as 0.01%
+  humidity = constrain(humidity, 1, 10000);
+
+  //ln(humidity) = exponent * ln(2) + ln(mantissa), the mantissa comes from the table with linear interpolation
+  uint16_t mantissa = humidity;
+  int8_t exponent = 15;
+  while (!(mantissa & 0x8000)) {
+    mantissa <<= 1;
+    exponent--;
+  }
+  uint8_t index = (mantissa >> 10) & 0x1F;
+  int32_t lnLow = pgm_read_word(&lnMantissa[index]);
+  int32_t lnHigh = pgm_read_word(&lnMantissa[index + 1]);
+  int32_t lnHumidity = exponent * LN2_Q16 + lnLow + (((lnHigh - lnLow) * (mantissa & 0x3FF)) >> 10) - LN10000_Q16;
+
+  //gamma = alpha * T / (beta + T) + ln(RH / 100), as Q12
+  int32_t gamma = (DEW_POINT_ALPHA * temp) / (DEW_POINT_BETA + temp) + ((lnHumidity + 8) >> 4);
+
+  //dew point = beta * gamma / (alpha - gamma), rounded to the nearest centi-degree
+  int32_t numerator = DEW_POINT_BETA * gamma;
+  int32_t denominator = DEW_POINT_ALPHA - gamma;
+  return (numerator + (numerator >= 0 ? denominator : -denominator) / 2) / denominator;
+}//end of calculateDewPoint
@@ -40,7 +40,7 @@
 const uint32_t serialSpeed = 115200; //values are: (9600, 19200, 38400, 57600, (default 115200), 230400)
 
 //----- (UA) (COVER) -----
-const uint32_t timeToMoveCover = 5000;  //(ms) time it takes to move between open/close positions (set between 1000(fast)-10000(slow) ms, recommend (5000 ms))
+uint32_t timeToMoveCover = 5000;  //(ms) time it takes to move between open/close positions (set between 1000(fast)-10000(slow) ms, recommend (5000 ms)), adjust at runtime with the X command (see manual) where it is saved to memory
 
 //----- (UA) (COVER) PRIMARY SERVO PARAMETERS -----
 const uint16_t primaryServoMinPulseWidth = 500; //refer to servo manufacture for usec pulses and set accordingly
@@ -69,16 +69,32 @@ const uint8_t secondaryServoCloseCoverAngle = 180; //position angle servo closes
 //----- (UA) (LIGHT) -----
 uint8_t maxBrightness = 255; //choose one of the following max number of steps: (max # of levels:steps between each value) -> ((light will be on or off 1:255), default 5:51, 17:15, 51:5, 85:3, (default 255:1))
 bool autoON = false; //adjust only if using manual-only mode, see manual for details 
+const uint8_t rampTimePerLevel = 4; //(ms) time to move the light one of 255 perceived levels (4 = about 1 second from off to full), ramping avoids the inrush of a jump on EL panels, 0 switches instantly
 
 //----- (UA) (HEATER) -----
-const uint32_t heaterShutoff = 3600000; //(ms) max time for manual heating (3600000 = one hour)
-const float deltaPoint = 5.0;  //(degrees) target temperature difference above ambient temp for dew control
+uint32_t heaterShutoff = 3600000; //(ms) max time for manual heating (3600000 = one hour), adjust at runtime with the X command (see manual) where it is saved to memory
+float deltaPoint = 5.0;  //(degrees) target temperature difference above ambient temp for dew control, adjust at runtime with the X command (see manual) where it is saved to memory
+
+//----- (UA) (HEATER) CONTROL GAINS -----
+//starting gains for both heaters, adjust at runtime with the J command (see manual) where they are saved to memory
+const int16_t defaultHeaterKp = 40;  //(PWM per degree) below target
+const int16_t defaultHeaterKi = 20;  //(PWM per degree per second x0.01) accumulated below target
+const int16_t defaultHeaterKff = 8;  //(PWM per degree) the target sits above outside temp, 0 disables feed-forward
+
+//----- (UA) (HEATER) PROBE RESOLUTION -----
+//starting DS18B20 resolution (9-12 bits), adjust at runtime with the N command (see manual) where it is saved to memory
+const uint8_t defaultProbeResolution = 10; //(bits) 0.25 degree steps in 188 ms, 12 bits is 0.0625 degrees in 750 ms
 
 //----- (UA) (HEATER) NUMBER OF HEATING MODULES -----
 //----- UNCOMMENT UP TO TWO (2) HEATERS, SEE MANUAL FOR DETAILS -----
 #define HEATER_ONE_INSTALLED
 #define HEATER_TWO_INSTALLED
 
+//----- (UA) (HEATER) BOTH HEATER PROBES ON ONE WIRE -----
+//----- UNCOMMENT TO WIRE BOTH DS18B20 PROBES TO PIN 4, PIN 7 IS THEN FREE, SEE MANUAL FOR DETAILS -----
+//----- probes are assigned in ROM order, if the channels read swapped, swap the probes between the heater straps -----
+//#define SHARED_ONEWIRE_BUS
+
 //----- (UA) (HEATER) TEMPERATURE & HUMIDTY SENSOR -----
 //----- UNCOMMENT ONLY ONE OPTION, SEE MANUAL FOR DETAILS -----
 #define ENABLE_BME280
@@ -99,13 +115,42 @@ const char* dlcVersion = "v1.2.0";
 //----- MEMORY -----
 #ifdef ENABLE_SAVING_TO_MEMORY
   #include <EEPROMWearLevel.h>
-  #define EEPROM_LAYOUT_VERSION 1
+  #include <util/crc16.h>
+  #define EEPROM_LAYOUT_VERSION 6
   #define AMOUNT_OF_INDEXES 4
   #define EEPROM_LENGTH_TOUSE 1023
   #define SAVED_COVER_STATE 0
   #define SAVED_PANEL_VALUE 1
-  #define SAVED_BROADBAND_VALUE 2
-  #define SAVED_NARROWBAND_VALUE 3
+  #define SAVED_SETTINGS_A 2 //settings alternate between two slots, each save overwrites the older record
+  #define SAVED_SETTINGS_B 3
+  #define SETTINGS_SCHEMA 2 //increment when the Settings record changes, older records are then ignored
+
+  //every runtime setting in one record, a reset during a save (or the wrap that clears a slot first) only loses the
+  //record being written, the other slot still holds the previous one
+  struct Settings {
+    uint8_t schema;            //SETTINGS_SCHEMA the record was written with
+    uint32_t stabilizeTime;    //(ms)
+    uint8_t autoON;
+    uint8_t broadbandValue;
+    uint8_t narrowbandValue;
+    uint32_t timeToMoveCover;  //(ms)
+    uint8_t autoHeat;
+    uint8_t heatOnClose;
+    float deltaPoint;          //(degrees)
+    uint32_t heaterShutoff;    //(ms)
+    int16_t heaterGains[2][3]; //kp, ki, kff per heater
+    uint8_t probeResolution;   //(bits)
+    uint8_t sequence;          //one more than the record it replaced, the newer of two valid slots is loaded
+    uint8_t crc;               //CRC-8 of the bytes above, checked on load
+  };
+  uint8_t settingsSlot = SAVED_SETTINGS_B; //slot of the current record, the next save goes to the other one
+  uint8_t settingsSequence = 0; //sequence of the current record
+  #define DIRTY_COVER_STATE 0x01 //bits of dirtySettings
+  #define DIRTY_PANEL_VALUE 0x02
+  const uint32_t settingsQuietTime = 10000; //(ms) dirty settings are written once unchanged this long, a brightness sweep ends in one write
+  uint8_t dirtySettings = 0; //settings changed in RAM but not yet written
+  uint32_t lastSettingChange; //holds time of the last change
+  uint32_t uptimeSeconds = 0; //(s) since boot for the wear report, unlike millis() it doesn't roll over after 49 days
 #endif
 
 //----- PIN ASSIGNMENT -----
@@ -113,7 +158,7 @@ const uint8_t lightPanel = 3;
 const uint8_t chOneHeatTempSensor = 4;
 const uint8_t chOneHeater = 5;
 const uint8_t chTwoHeater = 6;
-const uint8_t chTwoHeatTempSensor = 7;
+const uint8_t chTwoHeatTempSensor = 7; //unused with SHARED_ONEWIRE_BUS
 const uint8_t dhtSensor = 8;
 const uint8_t primeServo = 9;
 const uint8_t secondServo = 10;
@@ -178,11 +223,37 @@ uint8_t heaterState; //reports # 0:NotPresent, 1:Off, 3:On, 4:Unknown, 5:Error,
 #ifdef LIGHT_INSTALLED
   const uint8_t brightnessSteps = 255 / maxBrightness; //set steps size based on maxBrightness
   uint32_t startLightTimer; //holds start time for light
-  uint32_t stabilizeTime; //set delay to give light time to settle
+  uint32_t stabilizeTime; //set delay to give light time to settle after a full off to full change, scaled down for smaller changes
+  const uint32_t maxStabilizeTime = 60000; //(ms) bounds settleTime's stabilizeTime * levels product well inside 32 bits
   uint8_t lightValue = 0; //lightValue received and adjusted for Arduino
   uint8_t broadbandValue; //holds saved EEPROM value
   uint8_t narrowbandValue; //holds saved EEPROM value
   uint8_t previousLightPanelValue; //holds last ON value
+  uint8_t panelOutput = 0; //PWM currently on the panel, follows the ramp towards lightValue
+  uint8_t rampFrom; //perceived level the ramp started at
+  uint8_t rampTo; //perceived level the ramp ends at
+  uint32_t rampTime; //(ms) length of the current ramp
+  uint32_t settleTime; //(ms) ramp plus the share of stabilizeTime for the size of the change
+  const uint8_t minSettleLevels = 32; //smallest change stabilizeTime is scaled by, so even a one step tweak gets 1/8 of it
+  //PWM for each perceived level (gamma 2.2), the ramp steps through these so the light changes evenly to the eye
+  const uint8_t panelGamma[256] PROGMEM = {
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,
+      3,   3,   3,   3,   3,   4,   4,   4,   4,   5,   5,   5,   5,   6,   6,   6,
+      6,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,  10,  11,  11,  11,  12,
+     12,  13,  13,  13,  14,  14,  15,  15,  16,  16,  17,  17,  18,  18,  19,  19,
+     20,  20,  21,  22,  22,  23,  23,  24,  25,  25,  26,  26,  27,  28,  28,  29,
+     30,  30,  31,  32,  33,  33,  34,  35,  35,  36,  37,  38,  39,  39,  40,  41,
+     42,  43,  43,  44,  45,  46,  47,  48,  49,  49,  50,  51,  52,  53,  54,  55,
+     56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,  67,  68,  69,  70,  71,
+     73,  74,  75,  76,  77,  78,  79,  81,  82,  83,  84,  85,  87,  88,  89,  90,
+     91,  93,  94,  95,  97,  98,  99, 100, 102, 103, 105, 106, 107, 109, 110, 111,
+    113, 114, 116, 117, 119, 120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135,
+    137, 138, 140, 141, 143, 145, 146, 148, 149, 151, 153, 154, 156, 158, 159, 161,
+    163, 165, 166, 168, 170, 172, 173, 175, 177, 179, 181, 182, 184, 186, 188, 190,
+    192, 194, 196, 197, 199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221,
+    223, 225, 227, 229, 231, 234, 236, 238, 240, 242, 244, 246, 248, 251, 253, 255
+  };
 #endif
 
 //----- MANUAL OPERATION -----
@@ -200,36 +271,125 @@ uint8_t heaterState; //reports # 0:NotPresent, 1:Off, 3:On, 4:Unknown, 5:Error,
   #include <Wire.h>
   #include <OneWire.h>
   #include <DallasTemperature.h>
+  #include "dew_point.h" //fixed-point dew point, also built by the host test
   bool autoHeat = false; //true if always on auto control
   bool manualHeat = false; //true if activated
   bool heatOnClose = false; //if true turns heater on after closing from open position
-  bool heaterError = false; //flag turns true if sensor error occurs
-  bool heaterUnknown = false; //flag
-  uint8_t errorCounter = 0; //counter to track consecutive errors
+  bool heaterError = false; //flag turns true if the outside sensor or every heater probe is in error
+  bool heaterUnknown = false; //flag turns true while the outside sensor or every heater probe is retrying
   const uint8_t maxErrorCount = 5; //threshold for consecutive errors
+  const uint8_t samplePhases = 3; //outside sensor, heater one, heater two each read in their own part of dewInterval
+  uint8_t samplePhase = samplePhases - 1; //first phase run reads the outside sensor
+
+  //each sensor keeps its own health so a bad heater probe only isolates its own channel
+  struct SensorHealth {
+    uint8_t state;      //0:OK, 1:Unknown (retrying), 2:Error (isolated until the heater is reset)
+    uint8_t errorCount; //consecutive failed reads
+  };
+  SensorHealth ambientHealth = {0, 0};
+
+  //a heater channel's DS18B20, read by ROM once it has been found
+  struct HeaterProbe {
+    OneWire& wire;
+    DallasTemperature& sensor;
+    uint8_t index;          //position in the bus search, the probe at 0 starts the conversions on its bus
+    DeviceAddress address;  //family byte 0 until the probe has been found
+    uint8_t state;          //0:Idle, 1:Converting, 2:Reading (in the background), 3:Read
+    uint32_t conversionMillis;
+    uint8_t frame[10];      //match ROM + read scratchpad, sent a byte per loop by the frame
+    uint8_t scratchPad[9];
+  };
+  const uint8_t probeReadMargin = 40; //(ms) the background scratchpad read is 20 pieces of up to 1 ms, one per loop, started this far ahead of its phase
+  uint8_t probeResolution = defaultProbeResolution; //(bits) conversions are budgeted from it
+  #ifdef SHARED_ONEWIRE_BUS
+    OneWire oneWireA(chOneHeatTempSensor); //setup oneWire instance to communicate with both sensors
+    DallasTemperature heaterSensors(&oneWireA);
+  #endif
   const float maxPWM = 255.0;    //max PWM value for heater control
   uint32_t previousDewMillis; //timing for dew control
   uint32_t startHeaterTimer;
-  float outsideTemp, humidityLevel, dewPoint; //sensors to monitor outdoor environment
-
-  //dew heater system constants - DO NOT MODIFY
-  const float DEW_POINT_ALPHA = 17.27;    // August-Roche-Magnus dew point constant
-  const float DEW_POINT_BETA = 237.7;     // August-Roche-Magnus dew point constant
-  const float PWM_MAP_MULTIPLIER = 100.0; // PWM mapping scale factor
-  const float PWM_MAP_RANGE = 500.0;      // PWM mapping range value
+  float outsideTemp, humidityLevel; //sensors to monitor outdoor environment
+  int16_t dewPoint; //(centi-degrees)
+
+  //dew heater system constants - DO NOT MODIFY, the dew point constants are in dew_point.h
+  const int32_t PWM_SCALE = 100;          // controller terms are PWM x100, temperatures centi-degrees
+
+  //PI controller with feed-forward, one per heater channel
+  struct HeaterGains {
+    int16_t kp;  //PWM per degree of error
+    int16_t ki;  //PWM per degree second of accumulated error, x0.01
+    int16_t kff; //PWM per degree the target sits above outside temp
+  };
+
+  struct HeaterControl {
+    HeaterGains gains;
+    int32_t integral; //accumulated error, centi-degree seconds
+  };
+
+  //heater output stage, a sigma-delta modulator run from loop() on millis() slots instead of Timer0 PWM
+  //the error tracks requested minus delivered energy so late slots (blocking sensor reads) are made up afterwards
+  const uint16_t heaterSlotTime = 50;  //(ms) shortest on/off period, switching is at most 10 Hz
+  const int32_t heaterMaxDutyError = (int32_t)maxPWM * PWM_SCALE * 1000; //cap catch-up at one second of full power
+  struct HeaterOutput {
+    uint8_t pin;
+    uint16_t duty;       //PWM x100, 0 to maxPWM * PWM_SCALE
+    int32_t dutyError;   //requested minus delivered, PWM x100 ms
+    bool on;
+    uint32_t lastSlotMillis;
+  };
+
+  //relay auto-tune, switches one heater fully on/off around a setpoint and derives gains from the oscillation
+  const uint8_t autotuneCycles = 4;          //oscillations averaged, after a first settling one
+  const int16_t autotuneHysteresis = 20;     //(centi-degrees) either side of the setpoint
+  const int16_t autotuneSetpointLift = 300;  //(centi-degrees) minimum setpoint above the starting temp
+  const int16_t autotuneMaxOvershoot = 1500; //(centi-degrees) above the setpoint aborts the run
+  const uint32_t autotuneTimeout = 1800000;  //(ms) abort after 30 minutes
+  struct HeaterAutotune {
+    uint8_t heater;          //heater of the current or last run, 0 when none
+    uint8_t status;          //0:Idle, 1:Running, 2:Done, 3:Failed
+    bool relayHigh;
+    bool previousManualHeat; //restored when the run ends
+    uint8_t cycles;          //completed oscillations, including the settling one
+    int16_t setpoint;        //centi-degrees, 0 until the first sample
+    int16_t peakHigh, peakLow;
+    uint32_t startMillis, lastRiseMillis;
+    int32_t amplitudeSum;    //centi-degrees peak to peak over the measured cycles
+    uint32_t periodSum;      //(ms) over the measured cycles
+    uint32_t pwmSum, liftSum;
+    uint16_t samples;
+  };
+  HeaterAutotune autotune = {0};
 
   #ifdef HEATER_ONE_INSTALLED
-    OneWire oneWireA(chOneHeatTempSensor); //setup oneWire instance to communicate with sensor one
-    DallasTemperature chOneSensor(&oneWireA);
+    #ifdef SHARED_ONEWIRE_BUS
+      HeaterProbe heaterOneProbe = {oneWireA, heaterSensors, 0, {0}, 0, 0};
+    #else
+      OneWire oneWireA(chOneHeatTempSensor); //setup oneWire instance to communicate with sensor one
+      DallasTemperature chOneSensor(&oneWireA);
+      HeaterProbe heaterOneProbe = {oneWireA, chOneSensor, 0, {0}, 0, 0};
+    #endif
     float heaterOneTemp; //hold heater temp
     uint8_t heaterOnePWM = 0; //PWM value for heater one
+    HeaterControl heaterOneControl = {{defaultHeaterKp, defaultHeaterKi, defaultHeaterKff}, 0};
+    HeaterOutput heaterOneOutput = {chOneHeater, 0, 0, false, 0};
+    SensorHealth heaterOneHealth = {0, 0};
   #endif
 
   #ifdef HEATER_TWO_INSTALLED
-    OneWire oneWireB(chTwoHeatTempSensor); //setup oneWire instance to communicate with sensor two
-    DallasTemperature chTwoSensor(&oneWireB);
+    #if defined(SHARED_ONEWIRE_BUS) && defined(HEATER_ONE_INSTALLED)
+      HeaterProbe heaterTwoProbe = {oneWireA, heaterSensors, 1, {0}, 0, 0}; //read from the conversion heater one's probe started
+    #elif defined(SHARED_ONEWIRE_BUS)
+      HeaterProbe heaterTwoProbe = {oneWireA, heaterSensors, 0, {0}, 0, 0};
+    #else
+      OneWire oneWireB(chTwoHeatTempSensor); //setup oneWire instance to communicate with sensor two
+      DallasTemperature chTwoSensor(&oneWireB);
+      HeaterProbe heaterTwoProbe = {oneWireB, chTwoSensor, 0, {0}, 0, 0};
+    #endif
     float heaterTwoTemp; //hold heater temp
     uint8_t heaterTwoPWM = 0; //PWM value for heater two
+    HeaterControl heaterTwoControl = {{defaultHeaterKp, defaultHeaterKi, defaultHeaterKff}, 0};
+    HeaterOutput heaterTwoOutput = {chTwoHeater, 0, 0, false, 0};
+    SensorHealth heaterTwoHealth = {0, 0};
   #endif
   
   #ifdef ENABLE_BME280
@@ -239,9 +399,8 @@ uint8_t heaterState; //reports # 0:NotPresent, 1:Off, 3:On, 4:Unknown, 5:Error,
   #endif
   
   #ifdef ENABLE_DHT22
-    #include <DHT.h>
-    #define DHTTYPE DHT22 //dht sensor type
-    DHT dht(dhtSensor, DHTTYPE); //assign to pin 8 and define the object
+    #include <DHT_Async.h>
+    DHT_Async dht(dhtSensor); //assign to pin 8, edges are captured by the PCINT0 interrupt
     const uint32_t dewInterval = 2000; //interval for dew control updates (2 second)
   #endif
 
@@ -273,15 +432,16 @@ void setup(){
   pinMode(servoButton, INPUT_PULLUP); //enable internal pull-up resistor
   pinMode(lightButton, INPUT_PULLUP); //enable internal pull-up resistor
 
+  //start serial first so commands sent right after the port opens are buffered instead of lost
+  #if defined(ENABLE_SERIAL_CONTROL)
+    initializeComms();
+  #endif
+
   #ifdef ENABLE_SAVING_TO_MEMORY
     EEPROMwl.begin(EEPROM_LAYOUT_VERSION, AMOUNT_OF_INDEXES, EEPROM_LENGTH_TOUSE);
   #endif
   
   initializeVariables();
-
-  #if defined(ENABLE_SERIAL_CONTROL)
-    initializeComms();
-  #endif
 }//end of setup
 
 void loop(){
@@ -312,8 +472,24 @@ void loop(){
     monitorLightChange();
   #endif
 
+  //write settings once they stop changing
+  #ifdef ENABLE_SAVING_TO_MEMORY
+    manageSettings();
+  #endif
+
   //monitor and control heater
   #ifdef HEATER_INSTALLED
+    //outputs keep switching while the cover moves, only the control loop pauses
+    #ifdef HEATER_ONE_INSTALLED
+      driveHeaterOutput(heaterOneOutput);
+    #endif
+    #ifdef HEATER_TWO_INSTALLED
+      driveHeaterOutput(heaterTwoOutput);
+    #endif
+    #ifdef ENABLE_DHT22
+      dht.update(); //releases the start signal and decodes the captured frame
+    #endif
+
     #ifdef COVER_INSTALLED
       //if cover is not moving and heater isn't in error state
       if (currentCoverState !=2 && heaterState != 5){
@@ -343,9 +519,11 @@ void initializeVariables(){
 
     #ifdef LIGHT_INSTALLED
       previousLightPanelValue = EEPROMwl.get(SAVED_PANEL_VALUE, previousLightPanelValue);
-      broadbandValue = EEPROMwl.get(SAVED_BROADBAND_VALUE, broadbandValue);
-      narrowbandValue = EEPROMwl.get(SAVED_NARROWBAND_VALUE, narrowbandValue);
-  
+    #endif
+
+    loadSettings(); //values are left at their (UA) defaults if no valid record exists
+
+    #ifdef LIGHT_INSTALLED
       //set default for last brigtness value if none exists
       if (previousLightPanelValue < 0){
         previousLightPanelValue = 255;
@@ -411,6 +589,8 @@ void initializeVariables(){
   #endif
 
   #ifdef HEATER_INSTALLED
+    probeResolution = constrain(probeResolution, 9, 12);
+
     #ifdef ENABLE_BME280
       //check environment monitoring sensors exist before allowing function
       bool bmeStatus = bme.begin(0x76); //initalize sensor at address 0x76
@@ -418,18 +598,45 @@ void initializeVariables(){
         bmeStatus = bme.begin(0x77); //try 2nd address if failure
         if (!bmeStatus){
           heaterError = true; //report ERROR
+          ambientHealth.state = 2;
         }
       }
+
+      //weather monitoring settings from the datasheet, the sensor sleeps between the measurements we trigger
+      //so it doesn't warm itself, pressure is skipped as the dew point doesn't use it
+      if (bmeStatus){
+        bme.setSampling(Adafruit_BME280::MODE_FORCED,
+                        Adafruit_BME280::SAMPLING_X1, //temperature
+                        Adafruit_BME280::SAMPLING_NONE, //pressure
+                        Adafruit_BME280::SAMPLING_X1, //humidity
+                        Adafruit_BME280::FILTER_OFF);
+        bme.startForcedMeasurement(); //first reading is ready before the first control tick
+      }
     #else
       dht.begin();
+      dht.startRead(); //first reading is ready before the first control tick
+    #endif
+
+    //conversions are started ahead of the reads and budgeted by the scheduler instead of waited on
+    #ifdef SHARED_ONEWIRE_BUS
+      heaterSensors.begin();
+      heaterSensors.setWaitForConversion(false);
     #endif
 
     #ifdef HEATER_ONE_INSTALLED
-      chOneSensor.begin();
+      #ifndef SHARED_ONEWIRE_BUS
+        chOneSensor.begin();
+        chOneSensor.setWaitForConversion(false);
+      #endif
+      resolveProbeAddress(heaterOneProbe);
     #endif
 
     #ifdef HEATER_TWO_INSTALLED
-      chTwoSensor.begin();
+      #ifndef SHARED_ONEWIRE_BUS
+        chTwoSensor.begin();
+        chTwoSensor.setWaitForConversion(false);
+      #endif
+      resolveProbeAddress(heaterTwoProbe);
     #endif
 
     setHeaterState();
@@ -546,13 +753,13 @@ void initializeVariables(){
 
       //autoON set to (true)
       case 'A':
-        autoON = true;
+        setAutoOn(true);
         respondToCommand(receivedChars);
         break;
 
       //autoON set to (false)
       case 'a':
-        autoON = false;
+        setAutoOn(false);
         respondToCommand(receivedChars);
         break;
 
@@ -562,19 +769,25 @@ void initializeVariables(){
         respondToCommand(receivedChars);
         break;
 
+      //light settings, report (K) or set all at once (K<stabilizeTime>:<autoON>), reports as stabilizeTime:autoON
+      case 'K':
+        if (cmdParameter[0] != '\0') {
+          setLightSettings(cmdParameter);
+        }
+        getLightSettings();
+        respondToCommand(response);
+        break;
+
       //setBroadband & Narrowband values
       case 'D':
         if (cmdParameter[0] == 'B') {
           broadbandValue = lightValue;
-          #ifdef ENABLE_SAVING_TO_MEMORY
-            EEPROMwl.put(SAVED_BROADBAND_VALUE, broadbandValue);
-          #endif
         } else {
           narrowbandValue = lightValue;
-          #ifdef ENABLE_SAVING_TO_MEMORY
-            EEPROMwl.put(SAVED_NARROWBAND_VALUE, narrowbandValue);
-          #endif
         }
+        #ifdef ENABLE_SAVING_TO_MEMORY
+          saveSettings();
+        #endif
         respondToCommand(receivedChars);
         break;
 
@@ -602,15 +815,24 @@ void initializeVariables(){
           char tempBuf[10];            // buffer for float conversion
           response[0] = '\0';          // clear the response buffer
 
+          //a heater whose probe is failing reports err and is held off
           #ifdef HEATER_ONE_INSTALLED
-            dtostrf(heaterOneTemp, 0, 1, tempBuf);  // no leading spaces
+            if (heaterOneHealth.state != 0) {
+              strcpy(tempBuf, "err");
+            } else {
+              dtostrf(heaterOneTemp, 0, 1, tempBuf);  // no leading spaces
+            }
             snprintf(response, maxNumSendChars, "h1t:%s:h1p:%d", tempBuf, heaterOnePWM);
           #else
             snprintf(response, maxNumSendChars, "h1t:na:h1p:na");
           #endif
 
           #ifdef HEATER_TWO_INSTALLED
-            dtostrf(heaterTwoTemp, 0, 1, tempBuf);
+            if (heaterTwoHealth.state != 0) {
+              strcpy(tempBuf, "err");
+            } else {
+              dtostrf(heaterTwoTemp, 0, 1, tempBuf);
+            }
             snprintf(response + strlen(response), maxNumSendChars - strlen(response),
                     "|h2t:%s:h2p:%d", tempBuf, heaterTwoPWM);
           #else
@@ -629,19 +851,60 @@ void initializeVariables(){
                   ":h:%s", tempBuf);
 
           // dew point
-          dtostrf(dewPoint, 0, 1, tempBuf);
+          dtostrf(dewPoint / 100.0, 0, 1, tempBuf);
           snprintf(response + strlen(response), maxNumSendChars - strlen(response),
                   ":d:%s", tempBuf);
 
           respondToCommand(response);
           break;
 
+        //heater control gains, report (J<heater>) or set one (J<heater><P|I|F><value>), reports as kp:ki:kff
+        case 'J':
+          setHeaterGains(cmdParameter);
+          respondToCommand(response);
+          break;
+
+        //heater probe resolution in bits, report (N) or set (N<9-12>)
+        case 'N':
+          if (cmdParameter[0] != '\0' && !setProbeResolution(atoi(cmdParameter))) {
+            respondToCommand("?");
+            break;
+          }
+          utoa(probeResolution, response, 10); //convert integer to string
+          respondToCommand(response);
+          break;
+
+        //heater auto-tune, report (U) or start on a heater (U<heater>), reports as status:heater:cycles:kp:ki:kff
+        case 'U':
+          if (cmdParameter[0] != '\0' && !startAutotune(cmdParameter[0] - '0')) {
+            respondToCommand("?");
+            break;
+          }
+          getAutotune();
+          respondToCommand(response);
+          break;
+
+        //abort heater auto-tune
+        case 'u':
+          stopAutotune(3);
+          respondToCommand(receivedChars);
+          break;
+
+        //telemetry update interval (ms), 'Y' values change no faster than this
+        case 'y':
+          ultoa(dewInterval, response, 10); //convert integer to string
+          respondToCommand(response);
+          break;
+
         //autoHeat set to (true)
         case 'Q':
           autoHeat = true; //set flag
           heatOnClose = false; //reset flag
           manualHeat = false; //reset flag
           setHeaterState();
+          #ifdef ENABLE_SAVING_TO_MEMORY
+            saveSettings(); //heater mode is restored after a reset
+          #endif
           respondToCommand(receivedChars);
           break;
     
@@ -651,6 +914,9 @@ void initializeVariables(){
             autoHeat = false; //set flag
             resetErrorReadings();
             setHeaterState();
+            #ifdef ENABLE_SAVING_TO_MEMORY
+              saveSettings();
+            #endif
           }
           respondToCommand(receivedChars);
           break;
@@ -662,6 +928,9 @@ void initializeVariables(){
           manualHeat = false; //reset flag
           readSensors(); //verify sensors work and report so user can address before event
           setHeaterState();
+          #ifdef ENABLE_SAVING_TO_MEMORY
+            saveSettings();
+          #endif
           respondToCommand(receivedChars);
           break;
     
@@ -671,6 +940,9 @@ void initializeVariables(){
             heatOnClose = false; //set flag
             resetErrorReadings();
             setHeaterState();
+            #ifdef ENABLE_SAVING_TO_MEMORY
+              saveSettings();
+            #endif
           }
           respondToCommand(receivedChars);
           break;
@@ -703,10 +975,31 @@ void initializeVariables(){
             }
           }
           setHeaterState();
+          #ifdef ENABLE_SAVING_TO_MEMORY
+            saveSettings();
+          #endif
           respondToCommand(receivedChars);
           break;
       #endif //HEATER_INSTALLED
 
+      //runtime settings, report (X) or set one (X<key><value>), reports as st:<ms>:ao:<0|1>:bb:<0-255>:nb:<0-255>:mt:<ms>:ah:<0|1>:hc:<0|1>:dp:<degrees>:hs:<minutes>
+      case 'X':
+        if (cmdParameter[0] != '\0' && !setSetting(cmdParameter)) {
+          respondToCommand("?");
+          break;
+        }
+        getSettings();
+        respondToCommand(response);
+        break;
+
+      #ifdef ENABLE_SAVING_TO_MEMORY
+        //EEPROM wear since boot, reports as uptime(s) then writes:wraps:valuesPerWrap for the cover, panel and settings slots
+        case 'm':
+          getMemoryWear();
+          respondToCommand(response);
+          break;
+      #endif
+
       //DLC firmware version
       case 'V':
         respondToCommand(dlcVersion);
@@ -719,6 +1012,108 @@ void initializeVariables(){
     }//end of switch (cmd)
   }//end of processCommand
 
+  void getSettings(){
+    //features that are not installed report na, like the Y command
+    #ifdef LIGHT_INSTALLED
+      snprintf(response, maxNumSendChars, "st:%lu:ao:%d:bb:%d:nb:%d", (unsigned long)stabilizeTime, autoON ? 1 : 0,
+               broadbandValue, narrowbandValue);
+    #else
+      snprintf(response, maxNumSendChars, "st:na:ao:na:bb:na:nb:na");
+    #endif
+
+    #ifdef COVER_INSTALLED
+      snprintf(response + strlen(response), maxNumSendChars - strlen(response), ":mt:%lu", (unsigned long)timeToMoveCover);
+    #else
+      snprintf(response + strlen(response), maxNumSendChars - strlen(response), ":mt:na");
+    #endif
+
+    #ifdef HEATER_INSTALLED
+      char tempBuf[8];
+      dtostrf(deltaPoint, 0, 1, tempBuf);
+      snprintf(response + strlen(response), maxNumSendChars - strlen(response), ":ah:%d:hc:%d:dp:%s:hs:%lu",
+               autoHeat ? 1 : 0, heatOnClose ? 1 : 0, tempBuf, (unsigned long)(heaterShutoff / 60000));
+    #else
+      snprintf(response + strlen(response), maxNumSendChars - strlen(response), ":ah:na:hc:na:dp:na:hs:na");
+    #endif
+  }//end of getSettings
+
+  bool setSetting(const char* cmdParameter){
+    //expects a two letter key followed by the value, e.g. mt6000, heater modes are set with Q/q/E/e
+    const char* value = &cmdParameter[2];
+    char* end;
+    long number = strtol(value, &end, 10);
+    bool isInteger = (cmdParameter[1] != '\0' && *value != '\0' && *end == '\0');
+
+    #ifdef LIGHT_INSTALLED
+      if (strncmp(cmdParameter, "st", 2) == 0 && isInteger && number >= 0 && number <= (long)maxStabilizeTime) {
+        stabilizeTime = number;
+      }
+      else if (strncmp(cmdParameter, "ao", 2) == 0 && isInteger && (number == 0 || number == 1)) {
+        autoON = (number == 1);
+      }
+      else if (strncmp(cmdParameter, "bb", 2) == 0 && isInteger && number >= 0 && number <= 255) {
+        broadbandValue = number;
+      }
+      else if (strncmp(cmdParameter, "nb", 2) == 0 && isInteger && number >= 0 && number <= 255) {
+        narrowbandValue = number;
+      }
+      else
+    #endif
+    #ifdef COVER_INSTALLED
+      //a move in progress keeps the timing it started with
+      if (strncmp(cmdParameter, "mt", 2) == 0 && isInteger && number >= 1000 && number <= 10000 && currentCoverState != 2) {
+        timeToMoveCover = number;
+      }
+      else
+    #endif
+    #ifdef HEATER_INSTALLED
+      if (strncmp(cmdParameter, "dp", 2) == 0 && *value != '\0') {
+        double degrees = strtod(value, &end);
+        if (*end != '\0' || degrees < 0 || degrees > 20) {
+          return false;
+        }
+        deltaPoint = degrees;
+      }
+      else if (strncmp(cmdParameter, "hs", 2) == 0 && isInteger && number >= 1 && number <= 1440) {
+        heaterShutoff = number * 60000;
+      }
+      else
+    #endif
+    {
+      return false; //unknown key, feature not installed or value out of range
+    }
+
+    #ifdef ENABLE_SAVING_TO_MEMORY
+      saveSettings();
+    #endif
+    return true;
+  }//end of setSetting
+
+  #ifdef ENABLE_SAVING_TO_MEMORY
+    void getMemoryWear(){
+      //every data byte of a slot is rewritten about once per wrap, valuesPerWrap lets the host turn writes into wear
+      const uint8_t recordSizes[AMOUNT_OF_INDEXES] = {sizeof(uint8_t), sizeof(uint8_t), sizeof(Settings), sizeof(Settings)}; //cover state, panel value, settings A/B
+      unsigned long settingsWrites = 0;
+      unsigned long settingsWraps = 0;
+      int settingsValuesPerWrap = 0;
+      snprintf(response, maxNumSendChars, "%lu", (unsigned long)uptimeSeconds);
+      for (uint8_t idx = 0; idx < AMOUNT_OF_INDEXES; idx++) {
+        if (idx < SAVED_SETTINGS_A) {
+          snprintf(response + strlen(response), maxNumSendChars - strlen(response), ":%lu:%lu:%d", EEPROMwl.getWriteCount(idx),
+                   EEPROMwl.getWrapCount(idx), EEPROMwl.getMaxDataLength(idx) / recordSizes[idx]);
+        }
+        else {
+          //both settings slots are reported as one, saves alternate between them so their values per wrap add up
+          settingsWrites += EEPROMwl.getWriteCount(idx);
+          settingsWraps += EEPROMwl.getWrapCount(idx);
+          settingsValuesPerWrap += EEPROMwl.getMaxDataLength(idx) / recordSizes[idx];
+        }
+      }
+      snprintf(response + strlen(response), maxNumSendChars - strlen(response), ":%lu:%lu:%d", settingsWrites, settingsWraps,
+               settingsValuesPerWrap);
+    }//end of getMemoryWear
+  #endif
+
   void respondToCommand(const char* response) {
     //acknowledge response to command
     char buffer[maxNumSendChars];
@@ -911,6 +1306,11 @@ void initializeVariables(){
   void setMovement(){
     //sets time left and servo position based on previous and expected direction for calculation in monitorAndMoveCover
     detachServo = false;  //reset in case restart issued right after halt issued
+
+    //write pending settings before the servos draw current, a brownout reset during the move then loses nothing
+    #ifdef ENABLE_SAVING_TO_MEMORY
+      flushSettings();
+    #endif
     
     #ifdef USE_LINEAR
       if (!halt){
@@ -1061,7 +1461,7 @@ void initializeVariables(){
 
   #ifdef ENABLE_SAVING_TO_MEMORY
     void saveCurrentCoverState(){
-      EEPROMwl.put(SAVED_COVER_STATE, currentCoverState);
+      markSettingDirty(DIRTY_COVER_STATE); //written by manageSettings once the cover has settled
     }//end of saveCurrentCoverState
   #endif
 #endif //COVER_INSTALLED
@@ -1074,9 +1474,34 @@ void initializeVariables(){
 
 #ifdef LIGHT_INSTALLED
   void setStabilizeTime(const char* cmdParameter){
-    stabilizeTime = atoi(cmdParameter); //convert char to int
+    stabilizeTime = constrain(atol(cmdParameter), 0L, (long)maxStabilizeTime); //convert char to int, out of range values are clamped
+    #ifdef ENABLE_SAVING_TO_MEMORY
+      saveSettings(); //only written if changed
+    #endif
   }
 
+  void setAutoOn(bool value){
+    autoON = value;
+    #ifdef ENABLE_SAVING_TO_MEMORY
+      saveSettings(); //only written if changed
+    #endif
+  }
+
+  #ifdef ENABLE_SERIAL_CONTROL
+    void setLightSettings(const char* cmdParameter){
+      //expects stabilizeTime:autoON, e.g. 2000:1
+      const char* separator = strchr(cmdParameter, ':');
+      setStabilizeTime(cmdParameter); //atol stops at the separator
+      if (separator != NULL) {
+        setAutoOn(separator[1] == '1');
+      }
+    }
+
+    void getLightSettings(){
+      snprintf(response, maxNumSendChars, "%lu:%d", (unsigned long)stabilizeTime, autoON ? 1 : 0);
+    }
+  #endif
+
   #ifdef ENABLE_SERIAL_CONTROL
     void getCurrentBrightness(){
       itoa(lightValue / brightnessSteps, response, 10); //convert integer to string
@@ -1087,28 +1512,72 @@ void initializeVariables(){
     }
   #endif
 
+  //lowest perceived level whose PWM reaches pwm
+  uint8_t perceivedLevel(uint8_t pwm){
+    uint8_t low = 0;
+    uint8_t high = 255;
+    while (low < high){
+      uint8_t middle = ((uint16_t)low + high) / 2;
+      if (pgm_read_byte(&panelGamma[middle]) < pwm){
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+    return low;
+  }//end of perceivedLevel
+
   void turnPanelTo(){
     lightValue = lightValue * brightnessSteps; //determine the lightValue based on number of brightess steps
     calibratorState = 2; //set to 2:Not Ready
-    analogWrite(lightPanel, lightValue); //turn light to
+
+    //ramp from what is on the panel now, a change during a ramp carries on from where it got to
+    rampFrom = perceivedLevel(panelOutput);
+    rampTo = perceivedLevel(lightValue);
+    uint8_t levels = rampTo > rampFrom ? rampTo - rampFrom : rampFrom - rampTo;
+    rampTime = (uint32_t)levels * rampTimePerLevel;
+
+    //stabilizeTime is for a full off to full change, smaller changes are ready sooner
+    settleTime = rampTime + stabilizeTime * max(levels, minSettleLevels) / 255;
+
+    if (rampTime == 0){
+      panelOutput = lightValue;
+      analogWrite(lightPanel, panelOutput); //turn light to
+    }
 
     startLightTimer = millis(); //start timer for stabilizeLight
   }//end of turnPanelON
   
   void turnPanelOff(){
     analogWrite(lightPanel, 0);
+    panelOutput = 0;
     lightValue = 0;
     calibratorState = 1;  //1:Off
   }//end of turnPanelOff
   
   void monitorLightChange(){
-    //if light changed, report Ready after defined time
+    //if light changed, ramp to it and report Ready after defined time
     if (calibratorState == 2){
-      if (millis() - startLightTimer >= stabilizeTime){
+      uint32_t elapsed = millis() - startLightTimer;
+
+      if (panelOutput != lightValue){
+        uint8_t output = lightValue; //land on the exact value, it may fall between table entries
+        if (elapsed < rampTime){
+          uint8_t level = rampFrom + ((int32_t)rampTo - rampFrom) * (int32_t)elapsed / (int32_t)rampTime;
+          output = pgm_read_byte(&panelGamma[level]);
+        }
+        //only ever move towards lightValue, the start level can round past the current output
+        if ((lightValue > panelOutput && output > panelOutput) || (lightValue < panelOutput && output < panelOutput)){
+          panelOutput = output;
+          analogWrite(lightPanel, panelOutput);
+        }
+      }
+
+      if (elapsed >= settleTime){
         calibratorState = 3;
         previousLightPanelValue = lightValue;
           #ifdef ENABLE_SAVING_TO_MEMORY
-            EEPROMwl.put(SAVED_PANEL_VALUE, previousLightPanelValue);
+            markSettingDirty(DIRTY_PANEL_VALUE); //written by manageSettings once brightness stops changing
           #endif
       }
     }
@@ -1117,6 +1586,13 @@ void initializeVariables(){
 
 #ifdef HEATER_INSTALLED
   void setHeaterState(){
+    //auto-tune runs under manual heat, end a run that lost it or a sensor before the state is derived
+    if (autotune.status == 1 && (heaterError || heaterUnknown || !manualHeat)) {
+      autotune.status = 3; //heater switched off or lost a sensor, auto-tune failed
+      //switched off by the user stays off, a lost sensor goes back to the mode from before the run
+      manualHeat = manualHeat && autotune.previousManualHeat;
+    }
+
     //report # 0:NotPresent, 1:Off, 2:Auto, 3:On, 4:Unknown, 5:Error, 6:Set (HeatOnClose)
     if (heaterError) {
         heaterState = 5; // Error
@@ -1136,11 +1612,13 @@ void initializeVariables(){
     //!!!!! SAFTEY FIRST !!!!! ensure PWM is shut off unless heater is set to ON or AUTO 
     if (heaterState != 2 && heaterState != 3){
       #ifdef HEATER_ONE_INSTALLED
-        analogWrite(chOneHeater, 0);
+        setHeaterDuty(heaterOneOutput, 0);
+        heaterOneControl.integral = 0; //start the next heating session without stored error
       #endif
 
       #ifdef HEATER_TWO_INSTALLED
-        analogWrite(chTwoHeater, 0);
+        setHeaterDuty(heaterTwoOutput, 0);
+        heaterTwoControl.integral = 0;
       #endif
     }
   }//end of setHeaterState
@@ -1148,26 +1626,64 @@ void initializeVariables(){
   void manageHeat(){
     if (!heaterError && (autoHeat || manualHeat)) {
       uint32_t currentDewMillis = millis();
+
+      //convert and read each probe in the background ahead of its phase, the phase then only checks the CRC
+      #ifdef HEATER_ONE_INSTALLED
+        serviceHeaterProbe(heaterOneProbe, 1, currentDewMillis);
+      #endif
+      #ifdef HEATER_TWO_INSTALLED
+        serviceHeaterProbe(heaterTwoProbe, 2, currentDewMillis);
+      #endif
       
-      if (currentDewMillis - previousDewMillis >= dewInterval){
+      //each sensor is read once per dewInterval, staggered so the blocking reads don't stack up
+      if (currentDewMillis - previousDewMillis >= dewInterval / samplePhases){
         previousDewMillis = currentDewMillis; //update time check
-  
-        //read sensors and check for errors
-        if (readSensors()) {
-          return; //skip further processing if there's an error
-        }
-        
-        //calculate dew point
-        float temp = ((DEW_POINT_ALPHA * outsideTemp) / (DEW_POINT_BETA + outsideTemp)) + log(humidityLevel/100.0);
-        dewPoint = (DEW_POINT_BETA * temp) / (DEW_POINT_ALPHA - temp);
+        samplePhase = (samplePhase + 1) % samplePhases;
 
-        #ifdef HEATER_ONE_INSTALLED
-          activateHeater(heaterOneTemp, chOneHeater, dewPoint, deltaPoint, maxPWM, PWM_MAP_MULTIPLIER, PWM_MAP_RANGE, heaterOnePWM);
-        #endif
+        switch (samplePhase) {
+          case 0:
+            //outside sensor feeds the dew point both channels share
+            if (readAmbient()) {
+              dewPoint = calculateDewPoint((int16_t)(outsideTemp * 100), (uint16_t)(humidityLevel * 100));
+            }
+            break;
 
-        #ifdef HEATER_TWO_INSTALLED
-          activateHeater(heaterTwoTemp, chTwoHeater, dewPoint, deltaPoint, maxPWM, PWM_MAP_MULTIPLIER, PWM_MAP_RANGE, heaterTwoPWM);
-        #endif
+          #ifdef HEATER_ONE_INSTALLED
+            case 1:
+              if (readHeaterProbe(heaterOneProbe, heaterOneTemp, heaterOneHealth, heaterOneOutput, heaterOneControl, heaterOnePWM) && ambientHealth.state == 0) {
+                if (autotune.status == 1 && autotune.heater == 1) {
+                  autotuneHeater(heaterOneTemp, heaterOneOutput, heaterOneControl, heaterOnePWM);
+                } else {
+                  activateHeater(heaterOneTemp, heaterOneOutput, heaterOneControl, heaterOnePWM);
+                }
+              }
+              else if (autotune.status == 1 && autotune.heater == 1) {
+                stopAutotune(3); //relay results are meaningless without a reading
+              }
+              break;
+          #endif
+
+          #ifdef HEATER_TWO_INSTALLED
+            case 2:
+              if (readHeaterProbe(heaterTwoProbe, heaterTwoTemp, heaterTwoHealth, heaterTwoOutput, heaterTwoControl, heaterTwoPWM) && ambientHealth.state == 0) {
+                if (autotune.status == 1 && autotune.heater == 2) {
+                  autotuneHeater(heaterTwoTemp, heaterTwoOutput, heaterTwoControl, heaterTwoPWM);
+                } else {
+                  activateHeater(heaterTwoTemp, heaterTwoOutput, heaterTwoControl, heaterTwoPWM);
+                }
+              }
+              else if (autotune.status == 1 && autotune.heater == 2) {
+                stopAutotune(3); //relay results are meaningless without a reading
+              }
+              break;
+          #endif
+        }
+
+        //start the outside measurement one phase ahead so it's done by the time it's read
+        if (samplePhase == samplePhases - 1) {
+          startAmbientMeasurement();
+        }
+        updateHeaterFaults();
       }
     }
   
@@ -1183,51 +1699,292 @@ void initializeVariables(){
     }
   }//end of manageHeat
 
-  void activateHeater(float heaterTemp, uint8_t heaterPin, float dewPoint, float deltaPoint, uint8_t maxPWM, float pwmMapMultiplier, uint8_t pwmMapRange, uint8_t& heaterPWM) {
-    if (heaterTemp < dewPoint + deltaPoint) {
-      //calculate difference from target (dew point + safety margin)
-      float tempDiff = (dewPoint + deltaPoint) - heaterTemp;
-      heaterPWM = map(tempDiff * pwmMapMultiplier, 0, pwmMapRange, 0, maxPWM);
-      heaterPWM = constrain(heaterPWM, 0, maxPWM);
-
-      //write PWM to heater
-      analogWrite(heaterPin, heaterPWM);
-    } else {
-      // If the temperature is above the target, ensure the heater is off
-      analogWrite(heaterPin, 0);
-      heaterPWM = 0; // Optionally reset the PWM value
+  void activateHeater(float heaterTemp, HeaterOutput& heaterOutput, HeaterControl& control, uint8_t& heaterPWM) {
+    //work in centi-degrees and PWM x100 so the controller runs on integer math
+    const int32_t maxOutput = (int32_t)maxPWM * PWM_SCALE;
+    int32_t target = dewPoint + (int32_t)(deltaPoint * 100); //dew point + safety margin
+    int32_t error = target - (int32_t)(heaterTemp * 100);
+    int32_t lift = target - (int32_t)(outsideTemp * 100);
+
+    //feed-forward covers the steady loss to the outside air, PI trims the rest
+    int32_t feedForward = (lift > 0) ? (int32_t)control.gains.kff * lift : 0;
+    int32_t proportional = (int32_t)control.gains.kp * error;
+    int32_t integral = (int32_t)control.gains.ki * (control.integral / PWM_SCALE);
+    int32_t output = feedForward + proportional + integral;
+
+    //anti-windup, stop integrating while the output is saturated in the direction of the error
+    if (!((output >= maxOutput && error > 0) || (output <= 0 && error < 0))) {
+      control.integral += error * (int32_t)dewInterval / 1000;
+
+      //keep the integral term within the PWM range
+      if (control.gains.ki > 0) {
+        int32_t integralLimit = maxOutput / control.gains.ki * PWM_SCALE;
+        control.integral = constrain(control.integral, -integralLimit, integralLimit);
+      } else {
+        control.integral = 0;
+      }
     }
+
+    //full controller resolution goes to the output stage, heaterPWM is the 0-255 equivalent for reporting
+    output = constrain(output, 0, maxOutput);
+    heaterPWM = (output + PWM_SCALE / 2) / PWM_SCALE;
+    setHeaterDuty(heaterOutput, output);
   }//end of activateHeater
+
+  void setHeaterDuty(HeaterOutput& heaterOutput, uint16_t duty){
+    heaterOutput.duty = duty;
+
+    //switch off at once rather than at the next slot
+    if (duty == 0) {
+      heaterOutput.dutyError = 0;
+      heaterOutput.on = false;
+      digitalWrite(heaterOutput.pin, LOW);
+    }
+  }//end of setHeaterDuty
+
+  void driveHeaterOutput(HeaterOutput& heaterOutput){
+    uint32_t now = millis();
+    uint32_t elapsed = now - heaterOutput.lastSlotMillis;
+    if (elapsed < heaterSlotTime) {
+      return;
+    }
+    heaterOutput.lastSlotMillis = now;
+
+    //integrate requested minus delivered energy over the slot that just ended
+    const int32_t fullDuty = (int32_t)maxPWM * PWM_SCALE;
+    elapsed = min(elapsed, (uint32_t)1000); //a long stall is capped by heaterMaxDutyError anyway
+    heaterOutput.dutyError += ((int32_t)heaterOutput.duty - (heaterOutput.on ? fullDuty : 0)) * (int32_t)elapsed;
+    heaterOutput.dutyError = constrain(heaterOutput.dutyError, -heaterMaxDutyError, heaterMaxDutyError);
+
+    //on while energy is owed, a full duty stays on and zero stays off
+    bool on = (heaterOutput.duty > 0) && (heaterOutput.dutyError > 0 || heaterOutput.duty >= fullDuty);
+    if (on != heaterOutput.on) {
+      heaterOutput.on = on;
+      digitalWrite(heaterOutput.pin, on ? HIGH : LOW);
+    }
+  }//end of driveHeaterOutput
+
+  bool startAutotune(uint8_t heater){
+    bool installed = false;
+    #ifdef HEATER_ONE_INSTALLED
+      installed |= (heater == 1);
+    #endif
+    #ifdef HEATER_TWO_INSTALLED
+      installed |= (heater == 2);
+    #endif
+    if (!installed || heaterError || autotune.status == 1) {
+      return false;
+    }
+
+    autotune = HeaterAutotune();
+    autotune.heater = heater;
+    autotune.status = 1;
+    autotune.relayHigh = true;
+    autotune.startMillis = millis();
+    autotune.previousManualHeat = manualHeat;
+
+    //run under manual heat so the heater is allowed to draw power
+    manualHeat = true;
+    startHeaterTimer = millis();
+    setHeaterState();
+    return true;
+  }//end of startAutotune
+
+  void stopAutotune(uint8_t status){
+    if (autotune.status != 1) {
+      return;
+    }
+
+    #ifdef HEATER_ONE_INSTALLED
+      if (autotune.heater == 1) {
+        setHeaterDuty(heaterOneOutput, 0);
+        heaterOnePWM = 0;
+      }
+    #endif
+    #ifdef HEATER_TWO_INSTALLED
+      if (autotune.heater == 2) {
+        setHeaterDuty(heaterTwoOutput, 0);
+        heaterTwoPWM = 0;
+      }
+    #endif
+
+    autotune.status = status;
+    manualHeat = autotune.previousManualHeat;
+    setHeaterState();
+  }//end of stopAutotune
+
+  void autotuneHeater(float heaterTemp, HeaterOutput& heaterOutput, HeaterControl& control, uint8_t& heaterPWM) {
+    int16_t temp = (int16_t)(heaterTemp * 100);
+    uint32_t now = millis();
+
+    //center the relay on the control target, or far enough above the strap to see it respond
+    if (autotune.setpoint == 0) {
+      int16_t target = dewPoint + (int16_t)(deltaPoint * 100);
+      autotune.setpoint = max(target, (int16_t)(temp + autotuneSetpointLift));
+      autotune.peakHigh = autotune.peakLow = temp;
+    }
+
+    if (now - autotune.startMillis >= autotuneTimeout || temp > autotune.setpoint + autotuneMaxOvershoot) {
+      stopAutotune(3);
+      return;
+    }
+
+    autotune.peakHigh = max(autotune.peakHigh, temp);
+    autotune.peakLow = min(autotune.peakLow, temp);
+    if (autotune.cycles > 0) {
+      autotune.pwmSum += heaterPWM;
+      autotune.liftSum += max((int32_t)autotune.setpoint - (int32_t)(outsideTemp * 100), (int32_t)0);
+      autotune.samples++;
+    }
+
+    if (autotune.relayHigh && temp > autotune.setpoint + autotuneHysteresis) {
+      autotune.relayHigh = false;
+    }
+    else if (!autotune.relayHigh && temp < autotune.setpoint - autotuneHysteresis) {
+      //a switch back to heating completes one oscillation, the first one only settles the strap
+      autotune.relayHigh = true;
+      if (autotune.cycles > 0) {
+        autotune.amplitudeSum += autotune.peakHigh - autotune.peakLow;
+        autotune.periodSum += now - autotune.lastRiseMillis;
+      }
+      autotune.cycles++;
+      autotune.lastRiseMillis = now;
+      autotune.peakHigh = autotune.peakLow = temp;
+
+      if (autotune.cycles > autotuneCycles) {
+        //relay amplitude d is half the PWM span, a is half the temperature swing
+        float amplitude = autotune.amplitudeSum / (2.0 * autotuneCycles * 100.0);
+        float period = autotune.periodSum / (autotuneCycles * 1000.0);
+        float ultimateGain = (4.0 * (maxPWM / 2.0)) / (PI * amplitude);
+
+        //Tyreus-Luyben PI, less aggressive than Ziegler-Nichols and kinder to the battery
+        float kp = ultimateGain / 3.2;
+        float integralTime = 2.2 * period;
+        control.gains.kp = constrain(lround(kp), 0, 10000);
+        control.gains.ki = constrain(lround(100.0 * kp / integralTime), 0, 10000);
+
+        //average power needed to hold the setpoint above the outside air
+        float lift = autotune.liftSum / (100.0 * autotune.samples);
+        if (lift > 0.5) {
+          control.gains.kff = constrain(lround((autotune.pwmSum / (float)autotune.samples) / lift), 0, 10000);
+        }
+        control.integral = 0;
+        saveHeaterGains();
+        stopAutotune(2);
+        return;
+      }
+    }
+
+    heaterPWM = autotune.relayHigh ? maxPWM : 0;
+    setHeaterDuty(heaterOutput, (uint16_t)heaterPWM * PWM_SCALE);
+  }//end of autotuneHeater
+
+  void saveHeaterGains(){
+    #ifdef ENABLE_SAVING_TO_MEMORY
+      saveSettings(); //only written if changed
+    #endif
+  }//end of saveHeaterGains
+
+  #ifdef ENABLE_SERIAL_CONTROL
+    void getAutotune(){
+      //gains of the heater being tuned, the result once status is 2:Done
+      HeaterGains gains = {0, 0, 0};
+      #ifdef HEATER_ONE_INSTALLED
+        if (autotune.heater == 1) {
+          gains = heaterOneControl.gains;
+        }
+      #endif
+      #ifdef HEATER_TWO_INSTALLED
+        if (autotune.heater == 2) {
+          gains = heaterTwoControl.gains;
+        }
+      #endif
+      snprintf(response, maxNumSendChars, "%d:%d:%d:%d:%d:%d", autotune.status, autotune.heater, autotune.cycles,
+               gains.kp, gains.ki, gains.kff);
+    }
+
+    void setHeaterGains(const char* cmdParameter){
+      //expects heater number, then optionally a gain letter and value, e.g. 1 or 1P40
+      HeaterControl* control = NULL;
+      #ifdef HEATER_ONE_INSTALLED
+        if (cmdParameter[0] == '1') {
+          control = &heaterOneControl;
+        }
+      #endif
+      #ifdef HEATER_TWO_INSTALLED
+        if (cmdParameter[0] == '2') {
+          control = &heaterTwoControl;
+        }
+      #endif
+
+      if (control == NULL) {
+        strcpy(response, "?"); //heater not installed
+        return;
+      }
+
+      if (cmdParameter[1] != '\0') {
+        int16_t value = constrain(atol(&cmdParameter[2]), 0, 10000);
+        switch (cmdParameter[1]) {
+          case 'P':
+            control->gains.kp = value;
+            break;
+          case 'I':
+            control->gains.ki = value;
+            break;
+          case 'F':
+            control->gains.kff = value;
+            break;
+        }
+        control->integral = 0; //old error history doesn't apply to new gains
+        saveHeaterGains();
+      }
+
+      snprintf(response, maxNumSendChars, "%d:%d:%d", control->gains.kp, control->gains.ki, control->gains.kff);
+    }//end of setHeaterGains
+  #endif
   
+  //read every sensor at once, used to check the sensors before an event and to retry after errors
   bool readSensors() {
-    bool errorReading = false;
-    static bool lastErrorReading = true; //track the previous state
-    
-    #ifdef HEATER_ONE_INSTALLED
-      //read DS18B20 heater temperature
-      chOneSensor.requestTemperatures();
-      heaterOneTemp = chOneSensor.getTempCByIndex(0);
-      if (heaterOneTemp == DEVICE_DISCONNECTED_C) {
-        errorReading = true;
+    #ifdef ENABLE_BME280
+      bme.takeForcedMeasurement(); //waits the few ms a conversion takes, this path is not run every tick
+    #endif
+    #ifdef ENABLE_DHT22
+      //finish the frame here, interrupts stay on while it's captured, too soon after the last read keeps that result
+      if (dht.startRead()) {
+        while (dht.isBusy()) {
+          dht.update();
+        }
       }
     #endif
+    readAmbient();
+
+    #ifdef HEATER_ONE_INSTALLED
+      readHeaterProbe(heaterOneProbe, heaterOneTemp, heaterOneHealth, heaterOneOutput, heaterOneControl, heaterOnePWM);
+    #endif
 
     #ifdef HEATER_TWO_INSTALLED
-      //read DS18B20 heater temperature
-      chTwoSensor.requestTemperatures();
-      heaterTwoTemp = chTwoSensor.getTempCByIndex(0);
-      if (heaterTwoTemp == DEVICE_DISCONNECTED_C) {
-        errorReading = true;
-      }
+      readHeaterProbe(heaterTwoProbe, heaterTwoTemp, heaterTwoHealth, heaterTwoOutput, heaterTwoControl, heaterTwoPWM);
     #endif
 
+    updateHeaterFaults();
+    return heaterError || heaterUnknown;
+  } //end of readSensors
+
+  //returns true if the outside temperature and humidity are usable
+  bool readAmbient() {
+    bool errorReading = false;
+
     #ifdef ENABLE_BME280
-      //read BME280 outside temperature and humidity
-      outsideTemp = bme.readTemperature();
-      humidityLevel = bme.readHumidity();
+      //a conversion still running is skipped rather than waited on, the previous values stay in use
+      if (bme.isMeasuring()) {
+        return ambientHealth.state == 0;
+      }
+
+      //read BME280 outside temperature and humidity in one burst, pressure isn't needed
+      bool burstRead = bme.readAll(&outsideTemp, NULL, &humidityLevel);
 
       //check if any reads failed or outside of expected values
-      if (isnan(outsideTemp) || isnan(humidityLevel) ||
+      if (!burstRead || isnan(outsideTemp) || isnan(humidityLevel) ||
           humidityLevel < 0 || humidityLevel > 100 ||
           outsideTemp < -40 || outsideTemp > 85) {
         errorReading = true;
@@ -1235,46 +1992,419 @@ void initializeVariables(){
     #endif
 
     #ifdef ENABLE_DHT22
-      //read DHT22 outside temperature and humidity
-      outsideTemp = dht.readTemperature();
-      humidityLevel = dht.readHumidity();
+      //a frame still being captured is skipped rather than waited on, the previous values stay in use
+      if (dht.isBusy()) {
+        return ambientHealth.state == 0;
+      }
 
-      //check if any reads failed
-      if (isnan(outsideTemp) || isnan(humidityLevel)) {
+      //read DHT22 outside temperature and humidity decoded from the last frame, fails on a bad checksum
+      if (!dht.getReading(outsideTemp, humidityLevel)) {
         errorReading = true;
       }
     #endif
-  
+
+    updateSensorHealth(ambientHealth, errorReading);
+    return !errorReading;
+  }//end of readAmbient
+
+  void startAmbientMeasurement() {
+    #ifdef ENABLE_BME280
+      bme.startForcedMeasurement();
+    #endif
+
+    #ifdef ENABLE_DHT22
+      dht.startRead();
+    #endif
+  }//end of startAmbientMeasurement
+
+  //returns true if the probe read a usable temperature, a failing probe switches its own heater off
+  bool readHeaterProbe(HeaterProbe& probe, float& heaterTemp, SensorHealth& health, HeaterOutput& heaterOutput, HeaterControl& control, uint8_t& heaterPWM) {
+    heaterTemp = DEVICE_DISCONNECTED_C;
+
+    //an isolated probe isn't read or searched for until resetErrorReadings, one good read mustn't drive its heater again
+    //its background conversion still runs, on a shared bus the probe at 0 converts for the others too
+    if (health.state == 2) {
+      probe.state = 0;
+      setHeaterDuty(heaterOutput, 0);
+      heaterPWM = 0;
+      control.integral = 0;
+      return false;
+    }
+
+    //scratchpad already read in the background, the configuration register always has its low 5 bits set
+    //so an empty scratchpad (which passes the CRC) is caught too, one left over from before heat was paused isn't used
+    if (probe.state == 3 && millis() - probe.conversionMillis <= dewInterval &&
+        OneWire::crc8(probe.scratchPad, 9) == 0 && (probe.scratchPad[4] & 0x1F) == 0x1F) {
+      int16_t raw = ((int16_t)probe.scratchPad[1] << 8) | probe.scratchPad[0];
+      raw &= ~((1 << (12 - probeResolution)) - 1); //bits below the resolution are undefined
+      heaterTemp = raw * 0.0625;
+    }
+    else {
+      //the probe at 0 owns its bus' conversion, on a shared bus the others read the last one completed in their phase
+      if (probe.index == 0) {
+        //a read outside the schedule (sensor checks, retries, heat just switched on) starts its own conversion
+        if (probe.state == 0 || millis() - probe.conversionMillis > dewInterval) {
+          startProbeConversion(probe);
+        }
+
+        //only the part of the conversion time that hasn't passed yet is waited for
+        uint32_t elapsed = millis() - probe.conversionMillis;
+        uint16_t budget = probe.sensor.millisToWaitForConversion(probeResolution);
+        if (elapsed < budget) {
+          delay(budget - elapsed);
+        }
+      }
+
+      //the bus is only searched when the probe hasn't been found yet or its last read failed
+      if (probe.address[0] != 0 || resolveProbeAddress(probe)) {
+        //read DS18B20 heater temperature straight from the cached ROM, the scratchpad CRC is still checked
+        heaterTemp = probe.sensor.getTempC(probe.address);
+
+        //a probe that was swapped or dropped off is searched for again on the next read
+        if (heaterTemp == DEVICE_DISCONNECTED_C) {
+          probe.address[0] = 0;
+        }
+      }
+    }
+    probe.state = 0;
+
+    bool errorReading = (heaterTemp == DEVICE_DISCONNECTED_C);
+    updateSensorHealth(health, errorReading);
+
     if (errorReading) {
-      errorCounter++;
-      if (errorCounter >= maxErrorCount) {
-        heaterUnknown = false; //clear unknown state
-        heaterError = true;    //mark the heater as having an error
-        //possibly add greaterErrorCount then:
-        //possibly add code to read through bme addresses and update
-        //possibly add code to read through DS18B20 addresses and update
-      } else {
-        heaterUnknown = true;  //set the heater to unknown state
+      setHeaterDuty(heaterOutput, 0);
+      heaterPWM = 0;
+      control.integral = 0;
+    }
+    return !errorReading;
+  }//end of readHeaterProbe
+
+  //search the bus for the channel's probe and cache its ROM, returns false if none answered
+  bool resolveProbeAddress(HeaterProbe& probe) {
+    if (!probe.sensor.getAddress(probe.address, probe.index)) {
+      probe.address[0] = 0; //a failed search can leave part of a ROM behind
+      return false;
+    }
+
+    //a new or reconnected probe may be at another resolution, only written to it if different
+    probe.sensor.setResolution(probe.address, probeResolution, true);
+    return true;
+  }//end of resolveProbeAddress
+
+  //skip ROM conversion without waiting, on a shared bus this converts every probe
+  //sent directly (~2 ms) rather than as a frame so a reading never comes from a conversion that didn't go out
+  void startProbeConversion(HeaterProbe& probe) {
+    probe.sensor.requestTemperatures();
+    probe.conversionMillis = millis();
+    probe.state = 1;
+  }//end of startProbeConversion
+
+  //fetch the probe's scratchpad by its cached ROM in the background, the phase finds it in probe.scratchPad
+  void startScratchPadRead(HeaterProbe& probe) {
+    //not found yet, the phase's read searches for it
+    if (probe.address[0] == 0) {
+      memset(probe.scratchPad, 0, sizeof(probe.scratchPad));
+      probe.state = 3;
+      return;
+    }
+
+    //a probe sharing the bus reads the conversion its owner just finished, that's when its reading dates from
+    if (probe.index != 0) {
+      probe.conversionMillis = millis();
+    }
+
+    //an aborted frame leaves part of the old scratchpad behind, cleared so it fails the checks instead of passing as new
+    memset(probe.scratchPad, 0, sizeof(probe.scratchPad));
+    probe.frame[0] = 0x55; //match ROM
+    memcpy(&probe.frame[1], probe.address, sizeof(DeviceAddress));
+    probe.frame[9] = 0xBE; //read scratchpad
+    if (startProbeFrame(probe, probe.frame, sizeof(probe.frame), probe.scratchPad, sizeof(probe.scratchPad))) {
+      probe.state = 2;
+    }
+  }//end of startScratchPadRead
+
+  //returns false if the probe's bus is already running a frame or frames are compiled out of OneWire
+  bool startProbeFrame(HeaterProbe& probe, const uint8_t* tx, uint8_t txCount, uint8_t* rx, uint8_t rxCount) {
+    #if ONEWIRE_FRAMES
+      return probe.wire.start_frame(tx, txCount, rx, rxCount);
+    #else
+      return false;
+    #endif
+  }//end of startProbeFrame
+
+  //move the probe's conversion and scratchpad read along, timed from its sample phase so both are done as it comes round
+  void serviceHeaterProbe(HeaterProbe& probe, uint8_t phase, uint32_t currentMillis) {
+    uint16_t budget = probe.sensor.millisToWaitForConversion(probeResolution);
+
+    switch (probe.state) {
+      case 0: {
+        uint8_t phasesAhead = (phase + samplePhases - samplePhase) % samplePhases;
+        if (phasesAhead == 0) {
+          phasesAhead = samplePhases; //just read, next read is a full interval away
+        }
+        int32_t untilRead = (int32_t)(previousDewMillis + phasesAhead * (dewInterval / samplePhases) - currentMillis);
+
+        //the probe at 0 starts its bus' conversion, on a shared bus the others only read the result
+        if (probe.index == 0 && untilRead <= budget + probeReadMargin) {
+          startProbeConversion(probe);
+        }
+        else if (probe.index != 0 && untilRead <= probeReadMargin) {
+          startScratchPadRead(probe);
+        }
+        break;
       }
-      setHeaterState();
-    } else {
-      if (lastErrorReading) { 
-        resetErrorReadings(); //reset only on transition from true to false
-        setHeaterState();
+
+      case 1:
+        //heat was paused since the conversion, start over for the next phase
+        if (currentMillis - probe.conversionMillis > dewInterval) {
+          probe.state = 0;
+        }
+        else if (currentMillis - probe.conversionMillis >= budget) {
+          startScratchPadRead(probe);
+        }
+        break;
+
+      #if ONEWIRE_FRAMES
+        case 2: {
+          //one piece of the frame per loop, the reset or a byte
+          uint8_t status = probe.wire.frame_poll();
+          if (status != ONEWIRE_FRAME_BUSY) {
+            //a missing probe or an aborted frame leaves an empty scratchpad, the phase's read then retries it directly
+            if (status != ONEWIRE_FRAME_DONE) {
+              memset(probe.scratchPad, 0, sizeof(probe.scratchPad));
+            }
+            probe.state = 3;
+          }
+          break;
+        }
+      #endif
+    }
+  }//end of serviceHeaterProbe
+
+  //returns false if the resolution is out of range
+  bool setProbeResolution(uint8_t bits) {
+    if (bits < 9 || bits > 12) {
+      return false;
+    }
+    probeResolution = bits;
+
+    #ifdef HEATER_ONE_INSTALLED
+      if (heaterOneProbe.address[0] != 0) {
+        heaterOneProbe.sensor.setResolution(heaterOneProbe.address, probeResolution, true);
+      }
+    #endif
+    #ifdef HEATER_TWO_INSTALLED
+      if (heaterTwoProbe.address[0] != 0) {
+        heaterTwoProbe.sensor.setResolution(heaterTwoProbe.address, probeResolution, true);
       }
+    #endif
+
+    #ifdef ENABLE_SAVING_TO_MEMORY
+      saveSettings(); //only written if changed
+    #endif
+    return true;
+  }//end of setProbeResolution
+
+  void updateSensorHealth(SensorHealth& health, bool errorReading) {
+    if (health.state == 2) {
+      return; //stays isolated until resetErrorReadings
     }
-  
-    lastErrorReading = errorReading; //update the last error state
-    return errorReading;
-  } //end of readSensors
+
+    if (errorReading) {
+      health.errorCount++;
+      health.state = (health.errorCount >= maxErrorCount) ? 2 : 1;
+    } else {
+      health.errorCount = 0;
+      health.state = 0;
+    }
+  }//end of updateSensorHealth
+
+  //the heater as a whole is only in error when the outside sensor or every heater probe is
+  void updateHeaterFaults() {
+    uint8_t worstProbe = 2;
+    #ifdef HEATER_ONE_INSTALLED
+      worstProbe = min(worstProbe, heaterOneHealth.state);
+    #endif
+    #ifdef HEATER_TWO_INSTALLED
+      worstProbe = min(worstProbe, heaterTwoHealth.state);
+    #endif
+    uint8_t state = max(ambientHealth.state, worstProbe);
+
+    bool error = (state == 2);
+    bool unknown = (state == 1);
+    if (error != heaterError || unknown != heaterUnknown) {
+      heaterError = error;
+      heaterUnknown = unknown;
+      setHeaterState();
+    }
+  }//end of updateHeaterFaults
 
   void resetErrorReadings(){
-    errorCounter = 0;        //reset error counter on successful reading
     heaterUnknown = false;   //clear unknown state
     heaterError = false;     //clear error state
+    ambientHealth = SensorHealth();
+    #ifdef HEATER_ONE_INSTALLED
+      heaterOneHealth = SensorHealth();
+    #endif
+    #ifdef HEATER_TWO_INSTALLED
+      heaterTwoHealth = SensorHealth();
+    #endif
   }//end of resetErrorReadings
 #endif //HEATER_INSTALLED
 
+#ifdef ENABLE_SAVING_TO_MEMORY
+  uint8_t settingsCrc(const Settings& settings){
+    //CRC-8 over every byte but the stored CRC itself
+    const uint8_t* data = (const uint8_t*)&settings;
+    uint8_t crc = 0;
+    for (uint8_t i = 0; i < sizeof(Settings) - 1; i++) {
+      crc = _crc8_ccitt_update(crc, data[i]);
+    }
+    return crc;
+  }//end of settingsCrc
+
+  bool readSettings(uint8_t slot, Settings& settings){
+    //an older schema or a damaged or half written record is not valid
+    memset(&settings, 0, sizeof(Settings)); //left as is if the slot was never written
+    EEPROMwl.get(slot, settings);
+    return settings.schema == SETTINGS_SCHEMA && settings.crc == settingsCrc(settings);
+  }//end of readSettings
+
+  void loadSettings(){
+    Settings settings;
+    Settings other;
+    bool valid = readSettings(SAVED_SETTINGS_A, settings);
+    bool otherValid = readSettings(SAVED_SETTINGS_B, other);
+
+    //the newer of two valid records, the sequence wraps so it is compared by difference
+    if (otherValid && (!valid || (int8_t)(other.sequence - settings.sequence) > 0)) {
+      settings = other;
+      settingsSlot = SAVED_SETTINGS_B;
+    }
+    else if (valid) {
+      settingsSlot = SAVED_SETTINGS_A;
+    }
+    else {
+      return; //no valid record keeps the (UA) defaults until the next save
+    }
+
+    settingsSequence = settings.sequence;
+
+    autoON = settings.autoON;
+    timeToMoveCover = settings.timeToMoveCover;
+    deltaPoint = settings.deltaPoint;
+    heaterShutoff = settings.heaterShutoff;
+    #ifdef LIGHT_INSTALLED
+      stabilizeTime = settings.stabilizeTime;
+      broadbandValue = settings.broadbandValue;
+      narrowbandValue = settings.narrowbandValue;
+    #endif
+    #ifdef HEATER_INSTALLED
+      autoHeat = settings.autoHeat;
+      heatOnClose = settings.heatOnClose;
+      probeResolution = settings.probeResolution;
+      #ifdef HEATER_ONE_INSTALLED
+        memcpy(&heaterOneControl.gains, settings.heaterGains[0], sizeof(HeaterGains)); //kp, ki, kff in the same order
+      #endif
+      #ifdef HEATER_TWO_INSTALLED
+        memcpy(&heaterTwoControl.gains, settings.heaterGains[1], sizeof(HeaterGains));
+      #endif
+    #endif
+  }//end of loadSettings
+
+  void saveSettings(){
+    //every setting goes into one record, written to the slot not holding the current record and only if something changed
+    Settings settings;
+    const int16_t defaultGains[3] = {defaultHeaterKp, defaultHeaterKi, defaultHeaterKff};
+    settings.schema = SETTINGS_SCHEMA;
+    settings.autoON = autoON;
+    settings.timeToMoveCover = timeToMoveCover;
+    settings.deltaPoint = deltaPoint;
+    settings.heaterShutoff = heaterShutoff;
+
+    //features that are not installed store defaults, so the record stays valid if they are added later
+    #ifdef LIGHT_INSTALLED
+      settings.stabilizeTime = stabilizeTime;
+      settings.broadbandValue = broadbandValue;
+      settings.narrowbandValue = narrowbandValue;
+    #else
+      settings.stabilizeTime = 0;
+      settings.broadbandValue = 25;
+      settings.narrowbandValue = 255;
+    #endif
+    #ifdef HEATER_INSTALLED
+      settings.autoHeat = autoHeat;
+      settings.heatOnClose = heatOnClose;
+      settings.probeResolution = probeResolution;
+    #else
+      settings.autoHeat = false;
+      settings.heatOnClose = false;
+      settings.probeResolution = defaultProbeResolution;
+    #endif
+    #ifdef HEATER_ONE_INSTALLED
+      memcpy(settings.heaterGains[0], &heaterOneControl.gains, sizeof(defaultGains));
+    #else
+      memcpy(settings.heaterGains[0], defaultGains, sizeof(defaultGains));
+    #endif
+    #ifdef HEATER_TWO_INSTALLED
+      memcpy(settings.heaterGains[1], &heaterTwoControl.gains, sizeof(defaultGains));
+    #else
+      memcpy(settings.heaterGains[1], defaultGains, sizeof(defaultGains));
+    #endif
+
+    //compared up to the sequence, the current record comes from the RAM copy without reading the EEPROM
+    Settings current;
+    if (readSettings(settingsSlot, current) && memcmp(&current, &settings, offsetof(Settings, sequence)) == 0) {
+      return;
+    }
+
+    settingsSlot = (settingsSlot == SAVED_SETTINGS_A) ? SAVED_SETTINGS_B : SAVED_SETTINGS_A;
+    settingsSequence++;
+    settings.sequence = settingsSequence;
+    settings.crc = settingsCrc(settings);
+    EEPROMwl.put(settingsSlot, settings);
+  }//end of saveSettings
+
+  void markSettingDirty(uint8_t setting){
+    dirtySettings |= setting;
+    lastSettingChange = millis(); //restart the quiet period
+  }//end of markSettingDirty
+
+  void manageSettings(){
+    static uint32_t uptimeMillis = 0;
+    while (millis() - uptimeMillis >= 1000) {
+      uptimeMillis += 1000;
+      uptimeSeconds++;
+    }
+
+    //write once nothing changed for settingsQuietTime, never in the middle of a move
+    if (dirtySettings == 0 || millis() - lastSettingChange < settingsQuietTime) {
+      return;
+    }
+    #ifdef COVER_INSTALLED
+      if (currentCoverState == 2) {
+        return;
+      }
+    #endif
+    flushSettings();
+  }//end of manageSettings
+
+  void flushSettings(){
+    //all dirty slots in one pass, put() skips values already in memory
+    #ifdef COVER_INSTALLED
+      if (dirtySettings & DIRTY_COVER_STATE) {
+        EEPROMwl.put(SAVED_COVER_STATE, currentCoverState);
+      }
+    #endif
+    #ifdef LIGHT_INSTALLED
+      if (dirtySettings & DIRTY_PANEL_VALUE) {
+        EEPROMwl.put(SAVED_PANEL_VALUE, previousLightPanelValue);
+      }
+    #endif
+    dirtySettings = 0;
+  }//end of flushSettings
+#endif //ENABLE_SAVING_TO_MEMORY
+
 #ifdef SHOW_HEARTBEAT
   void beat(){
     static uint32_t ledTime;
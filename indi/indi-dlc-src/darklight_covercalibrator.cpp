@@ -42,21 +42,75 @@ For more information, please refer to the full terms of the Creative Commons Att
 #include "darklight_covercalibrator.h"
 #include "indicom.h"
 #include "connectionplugins/connectionserial.h"
-#include <termios.h>
-#include <mutex>
+#include <chrono>
+#include <deque>
+#include <vector>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+//commands tracked on the Diagnostics tab
+static const char diagnosticOpcodes[] = "ZKPLBMTFAaSGDRYyJNUuQqEeWwOCHXm";
+static const char *DIAGNOSTICS_TAB = "Diagnostics";
+
+//EEPROM wear, rated erase/write cycles per cell of the ATmega328P and how often the firmware is asked
+static const double eepromEndurance = 100000;
+static const double eepromWarnYears = 10;
+static const std::chrono::minutes memoryWearInterval(10);
+
+//number of DLC units served by this driver process, set with the DLC_UNITS environment variable
+static const int maxUnits = 8;
+
+static class Loader
+{
+    public:
+        std::deque<std::unique_ptr<DarkLight_CoverCalibrator>> units;
 
-static std::unique_ptr<DarkLight_CoverCalibrator> mydriver(new DarkLight_CoverCalibrator());
-std::mutex serialMutex;
+        Loader()
+        {
+            int unitCount = 1;
+            const char *unitsEnv = getenv("DLC_UNITS");
+            if (unitsEnv != nullptr)
+            {
+                unitCount = std::max(1, std::min(maxUnits, atoi(unitsEnv)));
+            }
 
-DarkLight_CoverCalibrator::DarkLight_CoverCalibrator() : lightDisabled(false), coverIsMoving(false), lightIsReady(true),
-    autoOn(false), autoHeatOn(false), heatOnClose(false), heatModeIsChanging(false)
+            for (int unit = 1; unit <= unitCount; unit++)
+            {
+                units.push_back(std::unique_ptr<DarkLight_CoverCalibrator>(new DarkLight_CoverCalibrator(unit)));
+            }
+        }
+} loader;
+
+DarkLight_CoverCalibrator::DarkLight_CoverCalibrator(int unit) : lightDisabled(false), coverIsMoving(false),
+    lightIsReady(true), autoOn(false), autoHeatOn(false), heatOnClose(false), heatModeIsChanging(false)
 {
+    unitNumber = unit;
+
+    //first unit keeps the original name so existing configs and profiles still match
+    defaultName = "DarkLight Cover Calibrator";
+    if (unitNumber > 1)
+    {
+        defaultName += " " + std::to_string(unitNumber);
+
+        //INDIDEV (a name given by indiserver or the profile) would otherwise name every unit the same,
+        //the other units take it with their number so their properties and config files stay apart
+        const char *indiDev = getenv("INDIDEV");
+        if (indiDev != nullptr && indiDev[0] != '\0')
+        {
+            setDeviceName((std::string(indiDev) + " " + std::to_string(unitNumber)).c_str());
+        }
+    }
+
     setVersion(CDRIVER_VERSION_MAJOR, CDRIVER_VERSION_MINOR);
 }
 
 const char *DarkLight_CoverCalibrator::getDefaultName()
 {
-    return "DarkLight Cover Calibrator";
+    return defaultName.c_str();
 }
 
 bool DarkLight_CoverCalibrator::saveConfigItems(FILE *fp)
@@ -68,6 +122,12 @@ bool DarkLight_CoverCalibrator::saveConfigItems(FILE *fp)
     DisableLightSP.save(fp);
     AutoHeatOnSP.save(fp);
     HeatOnCloseSP.save(fp);
+    StatsCSVSP.save(fp);
+    TraceSP.save(fp);
+    StatsFileTP.save(fp);
+    TraceFileTP.save(fp);
+    TelemetryLogSP.save(fp);
+    TelemetryFileTP.save(fp);
 
     return true;
 }
@@ -84,7 +144,8 @@ bool DarkLight_CoverCalibrator::initProperties()
         return Handshake();
     });
     serialConnection->setDefaultBaudRate(Connection::Serial::B_115200);
-    serialConnection->setDefaultPort("/dev/ttyUSB0");
+    std::string defaultPort = "/dev/ttyUSB" + std::to_string(unitNumber - 1);
+    serialConnection->setDefaultPort(defaultPort.c_str());
     registerConnection(serialConnection);
 
     //----- COVER CONTROL -----
@@ -159,6 +220,16 @@ bool DarkLight_CoverCalibrator::initProperties()
     TurnHeaterSP.fill(getDeviceName(), "TURN_HEATER", "Heater", MAIN_CONTROL_TAB, IP_WO, ISR_1OFMANY, 60, IPS_IDLE);
     IDSnoopDevice(getDeviceName(), "TURN_HEATER");
 
+    //heater & environment telemetry
+    HeaterTelemetryNP[Heater1_Temp].fill("HEATER1_TEMP", "Heater 1 Temp (C)", "%0.1f", -100, 100, 0, 0);
+    HeaterTelemetryNP[Heater1_PWM].fill("HEATER1_PWM", "Heater 1 PWM", "%0.f", 0, 255, 0, 0);
+    HeaterTelemetryNP[Heater2_Temp].fill("HEATER2_TEMP", "Heater 2 Temp (C)", "%0.1f", -100, 100, 0, 0);
+    HeaterTelemetryNP[Heater2_PWM].fill("HEATER2_PWM", "Heater 2 PWM", "%0.f", 0, 255, 0, 0);
+    HeaterTelemetryNP[Ambient_Temp].fill("AMBIENT_TEMP", "Outside Temp (C)", "%0.1f", -100, 100, 0, 0);
+    HeaterTelemetryNP[Ambient_Humidity].fill("AMBIENT_HUMIDITY", "Humidity (%)", "%0.1f", 0, 100, 0, 0);
+    HeaterTelemetryNP[Dew_Point].fill("DEW_POINT", "Dew Point (C)", "%0.1f", -100, 100, 0, 0);
+    HeaterTelemetryNP.fill(getDeviceName(), "HEATER_TELEMETRY", "Heater", MAIN_CONTROL_TAB, IP_RO, 60, IPS_IDLE);
+
     //----- INITIAL CONTROLS -----
     //stabilize light time
     //set default time
@@ -210,12 +281,258 @@ bool DarkLight_CoverCalibrator::initProperties()
     HeatOnCloseSP.fill(getDeviceName(), "HEAT_ON_CLOSE", "Heater", OPTIONS_TAB, IP_WO, ISR_NOFMANY, 60, IPS_IDLE);
     IDSnoopDevice(getDeviceName(), "HEAT_ON_CLOSE");
 
+    //heater control gains, stored by the firmware so they are not saved to the config file
+    INDI::PropertyNumber *heaterGains[] = {&HeaterOneGainsNP, &HeaterTwoGainsNP};
+    for (int heater = 1; heater <= 2; heater++)
+    {
+        INDI::PropertyNumber &gains = *heaterGains[heater - 1];
+        gains[Gain_Kp].fill("KP", "Kp (PWM/C)", "%0.f", 0, 10000, 1, 0);
+        gains[Gain_Ki].fill("KI", "Ki (PWM/C.s x0.01)", "%0.f", 0, 10000, 1, 0);
+        gains[Gain_Kff].fill("KFF", "Feed-forward (PWM/C)", "%0.f", 0, 10000, 1, 0);
+        gains.fill(getDeviceName(), heater == 1 ? "HEATER1_GAINS" : "HEATER2_GAINS",
+                   heater == 1 ? "Heater 1 Control" : "Heater 2 Control", OPTIONS_TAB, IP_RW, 60, IPS_IDLE);
+        gains.onUpdate([this, heater, &gains]
+        {
+            //the requested values are already in gains, send them and reload what the firmware kept
+            setHeaterGains(heater, gains);
+        });//end of HeaterGainsNP
+    }
+
+    //heater probe resolution, stored by the firmware so it is not saved to the config file
+    ProbeResolutionNP[0].fill("RESOLUTION", "Resolution (bits)", "%0.f", 9, 12, 1, 10);
+    ProbeResolutionNP.fill(getDeviceName(), "HEATER_PROBE_RESOLUTION", "Heater", OPTIONS_TAB, IP_RW, 60, IPS_IDLE);
+    ProbeResolutionNP.onUpdate([this]
+    {
+        //the requested value is already in the property, send it and reload what the firmware kept
+        setProbeResolution();
+    });//end of ProbeResolutionNP
+
+    //runtime settings, stored by the firmware so they are not saved to the config file
+    SettingsNP[Setting_MoveTime].fill("MOVE_TIME", "Cover Move Time (ms)", "%0.f", 1000, 10000, 500, 5000);
+    SettingsNP[Setting_DeltaPoint].fill("DELTA_POINT", "Heat Above Dew Point (C)", "%0.1f", 0, 20, 0.5, 5);
+    SettingsNP[Setting_HeatShutoff].fill("HEAT_SHUTOFF", "Manual Heat Limit (min)", "%0.f", 1, 1440, 10, 60);
+    SettingsNP.fill(getDeviceName(), "FIRMWARE_SETTINGS", "Firmware Settings", OPTIONS_TAB, IP_RW, 60, IPS_IDLE);
+    SettingsNP.onUpdate([this]
+    {
+        //the requested values are already in the property, send them and reload what the firmware kept
+        setSettings();
+    });//end of SettingsNP
+
+    //heater auto-tune
+    AutotuneSP[Autotune_Heater1].fill("AUTOTUNE_HEATER1", "Tune Heater 1", ISS_OFF);
+    AutotuneSP[Autotune_Heater2].fill("AUTOTUNE_HEATER2", "Tune Heater 2", ISS_OFF);
+    AutotuneSP[Autotune_Abort].fill("AUTOTUNE_ABORT", "Abort", ISS_OFF);
+    AutotuneSP.fill(getDeviceName(), "HEATER_AUTOTUNE", "Auto-Tune", OPTIONS_TAB, IP_WO, ISR_ATMOST1, 60, IPS_IDLE);
+    AutotuneStatusTP[0].fill("AUTOTUNE_STATUS", "Status", "Idle");
+    AutotuneStatusTP.fill(getDeviceName(), "AUTOTUNE_STATUS", "Auto-Tune", OPTIONS_TAB, IP_RO, 60, IPS_IDLE);
+
+    AutotuneSP.onUpdate([this]
+    {
+        if (AutotuneSP[Autotune_Abort].getState() == ISS_ON)
+        {
+            char AbortResponse[DarkLight_Serial::responseSize] = {0};
+            if (sendCommand("u", AbortResponse))
+            {
+                LOG_INFO("Heater auto-tune aborted");
+            }
+        }
+        else
+        {
+            startAutotune(AutotuneSP[Autotune_Heater1].getState() == ISS_ON ? 1 : 2);
+        }
+
+        AutotuneSP.reset();
+        AutotuneSP.setState(IPS_IDLE);
+        AutotuneSP.apply();
+        getAutotune();
+        heatModeIsChanging = true;
+    });//end of AutotuneSP
+
+    //----- DIAGNOSTICS -----
+    //serial counters
+    SerialStatsNP[Stats_Commands].fill("COMMANDS", "Commands", "%0.f", 0, 0, 0, 0);
+    SerialStatsNP[Stats_Failures].fill("FAILURES", "Failed", "%0.f", 0, 0, 0, 0);
+    SerialStatsNP[Stats_Timeouts].fill("TIMEOUTS", "Timeouts", "%0.f", 0, 0, 0, 0);
+    SerialStatsNP[Stats_Retries].fill("RETRIES", "Retries", "%0.f", 0, 0, 0, 0);
+    SerialStatsNP[Stats_ReadErrors].fill("READ_ERRORS", "Read Errors", "%0.f", 0, 0, 0, 0);
+    SerialStatsNP[Stats_BytesWritten].fill("BYTES_WRITTEN", "Bytes Written", "%0.f", 0, 0, 0, 0);
+    SerialStatsNP[Stats_BytesRead].fill("BYTES_READ", "Bytes Read", "%0.f", 0, 0, 0, 0);
+    SerialStatsNP.fill(getDeviceName(), "SERIAL_STATS", "Serial", DIAGNOSTICS_TAB, IP_RO, 60, IPS_IDLE);
+
+    //latency of all commands
+    LatencyNP[Latency_P50].fill("P50", "p50 (ms)", "%0.1f", 0, 0, 0, 0);
+    LatencyNP[Latency_P95].fill("P95", "p95 (ms)", "%0.1f", 0, 0, 0, 0);
+    LatencyNP[Latency_P99].fill("P99", "p99 (ms)", "%0.1f", 0, 0, 0, 0);
+    LatencyNP[Latency_Max].fill("MAX", "max (ms)", "%0.1f", 0, 0, 0, 0);
+    LatencyNP.fill(getDeviceName(), "SERIAL_LATENCY", "Latency", DIAGNOSTICS_TAB, IP_RO, 60, IPS_IDLE);
+
+    //latency & counters per command
+    OpcodeStatsTP.resize(sizeof(diagnosticOpcodes) - 1);
+    for (size_t i = 0; i < OpcodeStatsTP.size(); i++)
+    {
+        char opcodeName[16];
+        snprintf(opcodeName, sizeof(opcodeName), "CMD_%c%s", diagnosticOpcodes[i], islower(diagnosticOpcodes[i]) ? "_LC" : "");
+        char opcodeLabel[8] = {diagnosticOpcodes[i], '\0'};
+        OpcodeStatsTP[i].fill(opcodeName, opcodeLabel, "");
+    }
+    OpcodeStatsTP.fill(getDeviceName(), "COMMAND_STATS", "Commands", DIAGNOSTICS_TAB, IP_RO, 60, IPS_IDLE);
+
+    //reset statistics
+    ResetStatsSP[0].fill("RESET_STATS", "Reset", ISS_OFF);
+    ResetStatsSP.fill(getDeviceName(), "RESET_STATS", "Statistics", DIAGNOSTICS_TAB, IP_WO, ISR_ATMOST1, 60, IPS_IDLE);
+
+    //write statistics to CSV at disconnect
+    ISState statsCSVState = {ISS_OFF};
+    IUGetConfigSwitch(getDeviceName(), "STATS_CSV", "STATS_CSV", &statsCSVState);
+    StatsCSVSP[0].fill("STATS_CSV", "Write CSV at Disconnect", statsCSVState);
+    StatsCSVSP.fill(getDeviceName(), "STATS_CSV", "Statistics", DIAGNOSTICS_TAB, IP_RW, ISR_NOFMANY, 60, IPS_IDLE);
+
+    //CSV file
+    char statsFile[MAXINDINAME * 4] = {0};
+    if (IUGetConfigText(getDeviceName(), "STATS_FILE", "STATS_FILE", statsFile, sizeof(statsFile)) != 0)
+    {
+        const char *home = getenv("HOME");
+        snprintf(statsFile, sizeof(statsFile), "%s/dlc_diagnostics.csv", home ? home : "/tmp");
+    }
+    StatsFileTP[0].fill("STATS_FILE", "CSV File", statsFile);
+    StatsFileTP.fill(getDeviceName(), "STATS_FILE", "Statistics", DIAGNOSTICS_TAB, IP_RW, 60, IPS_IDLE);
+
+    //serial trace, kept in memory and dumped on request, off by default since each enabled unit holds a 2 MB ring
+    ISState traceState = {ISS_OFF};
+    IUGetConfigSwitch(getDeviceName(), "SERIAL_TRACE", "TRACE_ENABLE", &traceState);
+    transport.getTrace().setEnabled(traceState == ISS_ON);
+    TraceSP[Trace_Enable].fill("TRACE_ENABLE", "Enable", traceState);
+    TraceSP[Trace_Dump].fill("TRACE_DUMP", "Dump", ISS_OFF);
+    TraceSP.fill(getDeviceName(), "SERIAL_TRACE", "Trace", DIAGNOSTICS_TAB, IP_RW, ISR_NOFMANY, 60, IPS_IDLE);
+
+    //each unit gets its own file so one unit's dump doesn't overwrite another's
+    char traceFile[MAXINDINAME * 4] = {0};
+    if (IUGetConfigText(getDeviceName(), "TRACE_FILE", "TRACE_FILE", traceFile, sizeof(traceFile)) != 0)
+    {
+        const char *home = getenv("HOME");
+        if (unitNumber == 1)
+        {
+            snprintf(traceFile, sizeof(traceFile), "%s/dlc_trace.bin", home ? home : "/tmp");
+        }
+        else
+        {
+            snprintf(traceFile, sizeof(traceFile), "%s/dlc_trace_%d.bin", home ? home : "/tmp", unitNumber);
+        }
+    }
+    TraceFileTP[0].fill("TRACE_FILE", "Trace File", traceFile);
+    TraceFileTP.fill(getDeviceName(), "TRACE_FILE", "Trace", DIAGNOSTICS_TAB, IP_RW, 60, IPS_IDLE);
+
+    //EEPROM wear since the firmware started, the endurance estimate assumes that rate from here on
+    MemoryWearNP[Wear_CoverWrites].fill("COVER_WRITES", "Cover State Writes", "%0.f", 0, 0, 0, 0);
+    MemoryWearNP[Wear_PanelWrites].fill("PANEL_WRITES", "Brightness Writes", "%0.f", 0, 0, 0, 0);
+    MemoryWearNP[Wear_SettingsWrites].fill("SETTINGS_WRITES", "Settings Writes", "%0.f", 0, 0, 0, 0);
+    MemoryWearNP[Wear_Wraps].fill("WRAPS", "Wrap Arounds", "%0.f", 0, 0, 0, 0);
+    MemoryWearNP[Wear_CyclesPerDay].fill("CYCLES_PER_DAY", "Cycles/Day (worst cell)", "%0.2f", 0, 0, 0, 0);
+    MemoryWearNP[Wear_YearsLeft].fill("YEARS_LEFT", "Years to Rated Endurance", "%0.1f", 0, 0, 0, 0);
+    MemoryWearNP.fill(getDeviceName(), "EEPROM_WEAR", "EEPROM", DIAGNOSTICS_TAB, IP_RO, 60, IPS_IDLE);
+
+    TraceSP.onUpdate([this]
+    {
+        transport.getTrace().setEnabled(TraceSP[Trace_Enable].getState() == ISS_ON);
+
+        if (TraceSP[Trace_Dump].getState() == ISS_ON)
+        {
+            TraceSP[Trace_Dump].setState(ISS_OFF);
+            if (transport.getTrace().dump(TraceFileTP[0].getText()))
+            {
+                LOGF_INFO("Serial trace written to %s, decode with dlc_trace_decode", TraceFileTP[0].getText());
+                TraceSP.setState(IPS_OK);
+            }
+            else
+            {
+                LOGF_ERROR("Cannot write serial trace to %s", TraceFileTP[0].getText());
+                TraceSP.setState(IPS_ALERT);
+            }
+        }
+        else
+        {
+            TraceSP.setState(IPS_OK);
+        }
+        TraceSP.apply();
+        saveConfig();
+    });//end of TraceSP
+
+    TraceFileTP.onUpdate([this]
+    {
+        TraceFileTP.setState(IPS_OK);
+        TraceFileTP.apply();
+        saveConfig();
+    });//end of TraceFileTP
+
+    //heater telemetry history, appended to a memory-mapped ring file
+    ISState telemetryLogState = {ISS_ON};
+    IUGetConfigSwitch(getDeviceName(), "TELEMETRY_LOG", "TELEMETRY_LOG", &telemetryLogState);
+    TelemetryLogSP[0].fill("TELEMETRY_LOG", "Record", telemetryLogState);
+    TelemetryLogSP.fill(getDeviceName(), "TELEMETRY_LOG", "Telemetry Log", DIAGNOSTICS_TAB, IP_RW, ISR_NOFMANY, 60,
+                        IPS_IDLE);
+
+    //each unit gets its own file, a log is mapped by one process only
+    char telemetryFile[MAXINDINAME * 4] = {0};
+    if (IUGetConfigText(getDeviceName(), "TELEMETRY_FILE", "TELEMETRY_FILE", telemetryFile, sizeof(telemetryFile)) != 0)
+    {
+        const char *home = getenv("HOME");
+        if (unitNumber == 1)
+        {
+            snprintf(telemetryFile, sizeof(telemetryFile), "%s/dlc_telemetry.bin", home ? home : "/tmp");
+        }
+        else
+        {
+            snprintf(telemetryFile, sizeof(telemetryFile), "%s/dlc_telemetry_%d.bin", home ? home : "/tmp", unitNumber);
+        }
+    }
+    TelemetryFileTP[0].fill("TELEMETRY_FILE", "Log File", telemetryFile);
+    TelemetryFileTP.fill(getDeviceName(), "TELEMETRY_FILE", "Telemetry Log", DIAGNOSTICS_TAB, IP_RW, 60, IPS_IDLE);
+
+    TelemetryLogSP.onUpdate([this]
+    {
+        openTelemetryLog();
+        saveConfig();
+    });//end of TelemetryLogSP
+
+    TelemetryFileTP.onUpdate([this]
+    {
+        openTelemetryLog();
+        TelemetryFileTP.setState(TelemetryLogSP.getState() == IPS_ALERT ? IPS_ALERT : IPS_OK);
+        TelemetryFileTP.apply();
+        saveConfig();
+    });//end of TelemetryFileTP
+
+    ResetStatsSP.onUpdate([this]
+    {
+        transport.resetStats();
+        updateDiagnostics();
+        LOG_INFO("Diagnostics statistics reset");
+
+        ResetStatsSP.reset();
+        ResetStatsSP.setState(IPS_IDLE);
+        ResetStatsSP.apply();
+    });//end of ResetStatsSP
+
+    StatsCSVSP.onUpdate([this]
+    {
+        StatsCSVSP.setState(IPS_OK);
+        StatsCSVSP.apply();
+        saveConfig();
+    });//end of StatsCSVSP
+
+    StatsFileTP.onUpdate([this]
+    {
+        StatsFileTP.setState(IPS_OK);
+        StatsFileTP.apply();
+        saveConfig();
+    });//end of StatsFileTP
+
     MoveToSP.onUpdate([this]
     {
         if (isConnected())
         {
             std::string coverStateText = CoverStateTP[0].getText();
-            char MoveToResponse[8] = {0};
+            char MoveToResponse[DarkLight_Serial::responseSize] = {0};
             switch (MoveToSP.findOnSwitchIndex())
             {
                 case Open:
@@ -295,7 +612,7 @@ bool DarkLight_CoverCalibrator::initProperties()
     {
         if (isConnected())
         {
-            char TurnLightResponse[8] = {0};
+            char TurnLightResponse[DarkLight_Serial::responseSize] = {0};
             std::string calibratorStateText = CalibratorStateTP[0].getText();
             std::string coverStateText = CoverStateTP[0].getText();
             switch (TurnLightSP.findOnSwitchIndex())
@@ -460,7 +777,7 @@ bool DarkLight_CoverCalibrator::initProperties()
     //Go to preset BB / NB values
     GoToSavedSP.onUpdate([this]
     {
-        char GoToSavedResponse[8] = {0};
+        char GoToSavedResponse[DarkLight_Serial::responseSize] = {0};
         if (TurnLightSP.findOnSwitchIndex() == Light_On)
         {
             switch (GoToSavedSP.findOnSwitchIndex())
@@ -512,7 +829,7 @@ bool DarkLight_CoverCalibrator::initProperties()
     //Save preset BB / NB values
     SetToSavedSP.onUpdate([this]
     {
-        char SetToSavedResponse[8] = {0};
+        char SetToSavedResponse[DarkLight_Serial::responseSize] = {0};
         if (TurnLightSP.findOnSwitchIndex() == Light_On)
         {
             switch (SetToSavedSP.findOnSwitchIndex())
@@ -615,7 +932,7 @@ bool DarkLight_CoverCalibrator::initProperties()
     {
         if (isConnected())
         {
-            char HeaterResponse[8] = {0};
+            char HeaterResponse[DarkLight_Serial::responseSize] = {0};
             std::string heaterStateText = HeaterStateTP[0].getText();
             switch (TurnHeaterSP.findOnSwitchIndex())
             {
@@ -770,10 +1087,13 @@ bool DarkLight_CoverCalibrator::initProperties()
 bool DarkLight_CoverCalibrator::Handshake()
 {
     //get port
-    PortFD = serialConnection->getPortFD();
+    transport.setPortFD(serialConnection->getPortFD());
+
+    //statistics cover one connection
+    transport.resetStats();
 
     //verify connected
-    if (PortFD == -1)
+    if (transport.getPortFD() == -1)
     {
         LOG_ERROR("Serial port is not open or invalid.");
         return false;
@@ -785,11 +1105,22 @@ bool DarkLight_CoverCalibrator::Handshake()
 
     // Send handshake command 'Z' and expect '?' in response
     const char *handshakeCommand = "Z";
-    char response[8] = {0}; // Assuming 8 bytes is sufficient for the response
+    char response[DarkLight_Serial::responseSize] = {0};
 
     LOG_DEBUG("Sending handshake command");
 
-    if (!sendCommand(handshakeCommand, response))
+    //opening the port resets most Arduino boards, so poll with short timeouts until the firmware
+    //answers instead of waiting out the full command timeout while the bootloader runs
+    const int pollTimeoutMs = 200;
+    const auto readyDeadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(4000);
+    bool ready = false;
+    do
+    {
+        ready = sendCommand(handshakeCommand, response, pollTimeoutMs, 1, true);
+    }
+    while (!ready && std::chrono::steady_clock::now() < readyDeadline);
+
+    if (!ready)
     {
         LOG_ERROR("Failed to send handshake command. Check baud rate");
         return false;
@@ -810,6 +1141,9 @@ bool DarkLight_CoverCalibrator::updateProperties()
 
     if (isConnected())
     {
+        //firmware that keeps its settings needs nothing resent, only settings that differ are sent below
+        firmwareSettings = getSettings();
+
         //define cover properties if present
         getCoverState();
         if (CoverStateTP[0].getText() != std::string("Not Present"))
@@ -827,18 +1161,15 @@ bool DarkLight_CoverCalibrator::updateProperties()
         std::string calibratorStateText = CalibratorStateTP[0].getText();
         if (calibratorStateText != "Not Present")
         {
-            //StabilizeTime
-            setStabilizeTime();
-
-            //AutoON
-            setAutoOn();
+            //StabilizeTime & AutoON
+            syncLightSettings();
 
             //lightDisable
             setLightDisabled();
 
             //get MaxBrightness
             LOG_DEBUG("Getting Max Brightness");
-            char MaxBrightnessResponse[8] = {0};
+            char MaxBrightnessResponse[DarkLight_Serial::responseSize] = {0};
             if (!sendCommand("M", MaxBrightnessResponse))
             {
             }
@@ -888,16 +1219,78 @@ bool DarkLight_CoverCalibrator::updateProperties()
             defineProperty(HeatOnCloseSP);
             defineProperty(HeaterStateTP);
             defineProperty(TurnHeaterSP);
+
+            //a heater channel that is not installed does not answer J
+            if (getHeaterGains(1, HeaterOneGainsNP))
+            {
+                defineProperty(HeaterOneGainsNP);
+            }
+            if (getHeaterGains(2, HeaterTwoGainsNP))
+            {
+                defineProperty(HeaterTwoGainsNP);
+            }
+
+            //firmware with blocking probe reads does not answer N
+            if (getProbeResolution())
+            {
+                defineProperty(ProbeResolutionNP);
+            }
+
+            //firmware without auto-tune does not answer U
+            if (getAutotune())
+            {
+                defineProperty(AutotuneSP);
+                defineProperty(AutotuneStatusTP);
+            }
+
+            getTelemetryInterval();
+            openTelemetryLog();
+            getTelemetry();
+            defineProperty(HeaterTelemetryNP);
+            defineProperty(TelemetryLogSP);
+            defineProperty(TelemetryFileTP);
         }
         else
         {
             LOG_INFO("Heater is reported as Not Present");
         }
 
+        if (firmwareSettings)
+        {
+            defineProperty(SettingsNP);
+        }
+
+        //diagnostics
+        updateDiagnostics();
+        defineProperty(SerialStatsNP);
+        defineProperty(LatencyNP);
+        defineProperty(OpcodeStatsTP);
+        defineProperty(ResetStatsSP);
+        defineProperty(StatsCSVSP);
+        defineProperty(StatsFileTP);
+        defineProperty(TraceSP);
+        defineProperty(TraceFileTP);
+
+        //firmware without EEPROM saving does not answer m
+        memoryWear = getMemoryWear();
+        if (memoryWear)
+        {
+            defineProperty(MemoryWearNP);
+        }
+
         SetTimer(getCurrentPollingPeriod());
     }
     else
     {
+        //keep the statistics of this connection
+        if (StatsCSVSP[0].getState() == ISS_ON && transport.getTotals().count > 0)
+        {
+            if (transport.writeStatsCSV(StatsFileTP[0].getText()))
+            {
+                LOGF_INFO("Diagnostics written to %s", StatsFileTP[0].getText());
+            }
+        }
+
         deleteProperty(CoverStateTP);
         deleteProperty(MoveToSP);
         deleteProperty(CalibratorStateTP);
@@ -915,97 +1308,34 @@ bool DarkLight_CoverCalibrator::updateProperties()
         deleteProperty(HeatOnCloseSP);
         deleteProperty(HeaterStateTP);
         deleteProperty(TurnHeaterSP);
+        deleteProperty(HeaterTelemetryNP);
+        deleteProperty(HeaterOneGainsNP);
+        deleteProperty(HeaterTwoGainsNP);
+        deleteProperty(ProbeResolutionNP);
+        deleteProperty(SettingsNP);
+        deleteProperty(AutotuneSP);
+        deleteProperty(AutotuneStatusTP);
+        deleteProperty(TelemetryLogSP);
+        deleteProperty(TelemetryFileTP);
+        telemetryLog.close();
+        deleteProperty(SerialStatsNP);
+        deleteProperty(LatencyNP);
+        deleteProperty(OpcodeStatsTP);
+        deleteProperty(ResetStatsSP);
+        deleteProperty(StatsCSVSP);
+        deleteProperty(StatsFileTP);
+        deleteProperty(TraceSP);
+        deleteProperty(TraceFileTP);
+        deleteProperty(MemoryWearNP);
     }
 
     return true;
 }//end of updateProperties
 
-bool DarkLight_CoverCalibrator::sendCommand(const char *command, const char *response)
+bool DarkLight_CoverCalibrator::sendCommand(const char *command, const char *response, int timeoutMs, int maxRetries,
+        bool quiet)
 {
-    std::lock_guard<std::mutex> lock(serialMutex); //acquire mutex for thread safety
-
-    if (PortFD == -1)
-    {
-        return false; //cannot send if port is not open
-    }
-
-    int nbytes_read = 0, nbytes_written = 0, tty_rc = 0;
-    char res[8] = {0};
-
-    //retry a maximum of 3 times
-    const int maxRetries = 3;
-    int retryCount = 0;
-
-    //form the command
-    std::string commandToSend = "<";
-    commandToSend += command;
-    commandToSend += ">";
-
-    LOGF_DEBUG("Sending command: %s", commandToSend.c_str());
-
-    do
-    {
-        //set a timeout of 5 seconds
-        int timeoutMs = 5000;
-
-        //use a loop with select to monitor the serial port with a timeout
-        while (true)
-        {
-            tcflush(PortFD, TCIOFLUSH);
-            if ((tty_rc = tty_write_string(PortFD, commandToSend.c_str(), &nbytes_written)) != TTY_OK)
-            {
-                char errorMessage[MAXRBUF];
-                tty_error_msg(tty_rc, errorMessage, MAXRBUF);
-                LOGF_ERROR("Serial write error: %s", errorMessage);
-                return false;
-            }
-
-            struct timeval timeout;
-            timeout.tv_sec = timeoutMs / 1000;
-            timeout.tv_usec = (timeoutMs % 1000) * 1000;
-
-            fd_set readfds;
-            FD_ZERO(&readfds);
-            FD_SET(PortFD, &readfds);
-
-            int selectResult = select(PortFD + 1, &readfds, nullptr, nullptr, &timeout);
-            if (selectResult == -1)
-            {
-                LOGF_ERROR("Serial select error: %s", strerror(errno));
-                return false;
-            }
-            else if (selectResult == 0)
-            {
-                LOG_ERROR("Serial read timed out");
-                break; //exit the inner loop and try again (retry)
-            }
-            else
-            {
-                //data is available for reading, proceed with tty_read_section
-                if ((tty_rc = tty_read_section(PortFD, res, '>', 1, &nbytes_read)) == TTY_OK)
-                {
-                    //response received successfully
-                    LOGF_DEBUG("Response received: %s", res);
-                    res[nbytes_read - 1] = '\0';
-
-                    //ensure response is copied back to the caller's buffer
-                    strcpy(const_cast<char*>(response), res + 1);
-                    return true; //success
-                }
-                else
-                {
-                    LOGF_ERROR("Serial read error: %s", res);
-                }
-            }
-        }
-
-        //increment the retry count
-        retryCount++;
-    }
-    while (retryCount < maxRetries);
-
-    LOG_ERROR("Maximum retry attempts reached. Transmission failed.");
-    return false; // Error
+    return transport.sendCommand(command, const_cast<char*>(response), timeoutMs, maxRetries, quiet);
 }//end of sendCommand
 
 bool DarkLight_CoverCalibrator::mainValues()
@@ -1043,6 +1373,20 @@ bool DarkLight_CoverCalibrator::mainValues()
         getHeaterState();
     }
 
+    //follow a running heater auto-tune until it reports a result
+    if (autotuneRunning)
+    {
+        getAutotune();
+    }
+
+    //refresh telemetry while the firmware is updating it, no faster than its dewInterval
+    const std::string heaterState = HeaterStateTP[0].getText();
+    if ((heaterState == "On" || heaterState == "Auto" || heaterState == "Unknown") &&
+            std::chrono::steady_clock::now() - lastTelemetry >= std::chrono::milliseconds(telemetryInterval))
+    {
+        getTelemetry();
+    }
+
     return true;
 }//end of mainValues
 
@@ -1054,9 +1398,161 @@ void DarkLight_CoverCalibrator::TimerHit()
     }
 
     mainValues();
+    updateDiagnostics();
+
+    //write counts change slowly, no need to ask every poll
+    if (memoryWear && std::chrono::steady_clock::now() - lastMemoryWear >= memoryWearInterval)
+    {
+        getMemoryWear();
+    }
+
     SetTimer(getCurrentPollingPeriod());
 }//end of TimerHit
 
+void DarkLight_CoverCalibrator::updateDiagnostics()
+{
+    const DarkLight_CommandStats totals = transport.getTotals();
+    SerialStatsNP[Stats_Commands].setValue(totals.count);
+    SerialStatsNP[Stats_Failures].setValue(totals.failures);
+    SerialStatsNP[Stats_Timeouts].setValue(totals.timeouts);
+    SerialStatsNP[Stats_Retries].setValue(totals.retries);
+    SerialStatsNP[Stats_ReadErrors].setValue(totals.readErrors);
+    SerialStatsNP[Stats_BytesWritten].setValue(totals.bytesWritten);
+    SerialStatsNP[Stats_BytesRead].setValue(totals.bytesRead);
+    SerialStatsNP.setState((totals.failures > 0 || totals.timeouts > 0) ? IPS_ALERT : IPS_OK);
+    SerialStatsNP.apply();
+
+    LatencyNP[Latency_P50].setValue(totals.percentile(0.50));
+    LatencyNP[Latency_P95].setValue(totals.percentile(0.95));
+    LatencyNP[Latency_P99].setValue(totals.percentile(0.99));
+    LatencyNP[Latency_Max].setValue(totals.maxLatencyMs);
+    LatencyNP.setState(IPS_OK);
+    LatencyNP.apply();
+
+    for (size_t i = 0; i < OpcodeStatsTP.size(); i++)
+    {
+        const DarkLight_CommandStats &stats = transport.getStats(diagnosticOpcodes[i]);
+        char summary[128];
+        snprintf(summary, sizeof(summary), "n=%u p50=%.1f p95=%.1f p99=%.1f max=%.1f ms, timeouts=%u retries=%u errors=%u",
+                 stats.count, stats.percentile(0.50), stats.percentile(0.95), stats.percentile(0.99), stats.maxLatencyMs,
+                 stats.timeouts, stats.retries, stats.readErrors);
+        OpcodeStatsTP[i].setText(summary);
+    }
+    OpcodeStatsTP.setState(IPS_OK);
+    OpcodeStatsTP.apply();
+}//end of updateDiagnostics
+
+bool DarkLight_CoverCalibrator::getMemoryWear()
+{
+    char WearResponse[DarkLight_Serial::responseSize] = {0};
+    LOG_DEBUG("Get EEPROM wear");
+    if (!sendCommand("m", WearResponse))
+    {
+        return false;
+    }
+
+    LOGF_DEBUG("EEPROM wear response: %s", WearResponse);
+    lastMemoryWear = std::chrono::steady_clock::now();
+
+    //reported as uptime(s) then writes:wraps:valuesPerWrap for the cover, panel and settings slots,
+    //'?' when the firmware predates the command or doesn't save to EEPROM
+    unsigned long uptime, writes[3], wraps[3], valuesPerWrap[3];
+    if (sscanf(WearResponse, "%lu:%lu:%lu:%lu:%lu:%lu:%lu:%lu:%lu:%lu", &uptime, &writes[0], &wraps[0], &valuesPerWrap[0],
+               &writes[1], &wraps[1], &valuesPerWrap[1], &writes[2], &wraps[2], &valuesPerWrap[2]) != 10)
+    {
+        return false;
+    }
+
+    //every data byte of a slot is written once per valuesPerWrap values, the busiest slot wears out first
+    double worstCycles = 0;
+    for (int slot = 0; slot < 3; slot++)
+    {
+        if (valuesPerWrap[slot] > 0)
+        {
+            worstCycles = std::max(worstCycles, static_cast<double>(writes[slot]) / valuesPerWrap[slot]);
+        }
+    }
+    const double uptimeDays = std::max(uptime, 1ul) / 86400.0;
+    const double cyclesPerDay = worstCycles / uptimeDays;
+    //no writes yet, report the rated endurance as out of reach
+    const double yearsLeft = cyclesPerDay > 0 ? std::min(eepromEndurance / cyclesPerDay / 365.0, 999.0) : 999.0;
+
+    MemoryWearNP[Wear_CoverWrites].setValue(writes[0]);
+    MemoryWearNP[Wear_PanelWrites].setValue(writes[1]);
+    MemoryWearNP[Wear_SettingsWrites].setValue(writes[2]);
+    MemoryWearNP[Wear_Wraps].setValue(wraps[0] + wraps[1] + wraps[2]);
+    MemoryWearNP[Wear_CyclesPerDay].setValue(cyclesPerDay);
+    MemoryWearNP[Wear_YearsLeft].setValue(yearsLeft);
+
+    //an hour of uptime is too short to tell a busy evening from a runaway write loop
+    const bool excessive = uptime >= 3600 && yearsLeft < eepromWarnYears;
+    if (excessive && MemoryWearNP.getState() != IPS_ALERT)
+    {
+        LOGF_WARN("EEPROM is being written %.1f times a day per cell, rated endurance is reached in %.1f years at this rate",
+                  cyclesPerDay, yearsLeft);
+    }
+    MemoryWearNP.setState(excessive ? IPS_ALERT : IPS_OK);
+    MemoryWearNP.apply();
+    return true;
+}//end of getMemoryWear
+
+void DarkLight_CoverCalibrator::traceState(const char *name, const std::string &previous, const char *current)
+{
+    if (previous == current)
+    {
+        return;
+    }
+
+    char entry[32];
+    int length = snprintf(entry, sizeof(entry), "%s=%s", name, current);
+    transport.getTrace().record(TRACE_STATE, entry, std::min<size_t>(length, sizeof(entry) - 1));
+}//end of traceState
+
+void DarkLight_CoverCalibrator::syncLightSettings()
+{
+    LOG_DEBUG("Syncing light settings");
+    int stabilizeTime = static_cast<int>(StabilizeTimeNP[0].getValue());
+    int autoOnValue = (AutoOnSP.findOnSwitchIndex() == Light_AutoOn) ? 1 : 0;
+
+    //firmware keeps StabilizeTime & AutoON in EEPROM, only send them when they differ
+    char SettingsResponse[DarkLight_Serial::responseSize] = {0};
+    if (!sendCommand("K", SettingsResponse))
+    {
+        LOG_WARN("Light settings query failed");
+        return;
+    }
+
+    LOGF_DEBUG("Light settings response: %s", SettingsResponse);
+    int savedStabilizeTime = 0, savedAutoOn = 0;
+    if (sscanf(SettingsResponse, "%d:%d", &savedStabilizeTime, &savedAutoOn) != 2)
+    {
+        //firmware without the settings command, fall back to one command per setting
+        LOG_DEBUG("Light settings not supported by firmware");
+        setStabilizeTime();
+        setAutoOn();
+        return;
+    }
+
+    if (savedStabilizeTime == stabilizeTime && savedAutoOn == autoOnValue)
+    {
+        autoOn = (autoOnValue == 1);
+        return;
+    }
+
+    //send all settings in one command
+    std::string command = "K" + std::to_string(stabilizeTime) + ":" + std::to_string(autoOnValue);
+    memset(SettingsResponse, 0, sizeof(SettingsResponse));
+    if (sendCommand(command.c_str(), SettingsResponse))
+    {
+        LOGF_DEBUG("Light settings response: %s", SettingsResponse);
+        autoOn = (autoOnValue == 1);
+    }
+    else
+    {
+        LOG_WARN("Light settings command failed");
+    }
+}//end of syncLightSettings
+
 void DarkLight_CoverCalibrator::setStabilizeTime()
 {
     LOG_DEBUG("Setting StabilizeTime");
@@ -1067,7 +1563,7 @@ void DarkLight_CoverCalibrator::setStabilizeTime()
     command += std::to_string(intValue);  //append integer value
 
     //send command
-    char StabilizeTimeResponse[8] = {0};
+    char StabilizeTimeResponse[DarkLight_Serial::responseSize] = {0};
     if (sendCommand(command.c_str(), StabilizeTimeResponse))
     {
         LOGF_DEBUG("StabilizeTime response: %s", StabilizeTimeResponse);
@@ -1081,7 +1577,7 @@ void DarkLight_CoverCalibrator::setStabilizeTime()
 void DarkLight_CoverCalibrator::setAutoOn()
 {
     LOG_DEBUG("Setting autoOn");
-    char AutoOnResponse[8] = {0};
+    char AutoOnResponse[DarkLight_Serial::responseSize] = {0};
     switch (AutoOnSP.findOnSwitchIndex())
     {
         case Light_AutoOn:
@@ -1135,7 +1631,8 @@ void DarkLight_CoverCalibrator::setLightDisabled()
 
 void DarkLight_CoverCalibrator::getCoverState()
 {
-    char CoverStateResponse[8] = {0};
+    char CoverStateResponse[DarkLight_Serial::responseSize] = {0};
+    const std::string previousCoverState = CoverStateTP[0].getText();
     LOG_DEBUG("Get CoverState");
     if (!sendCommand("P", CoverStateResponse))
     {
@@ -1191,6 +1688,7 @@ void DarkLight_CoverCalibrator::getCoverState()
                     LOG_WARN("CoverState: Invalid response value");
                     CoverStateTP[0].setText("Invalid Response");
             }
+            traceState("cover", previousCoverState, CoverStateTP[0].getText());
             CoverStateTP.setState(IPS_IDLE);
             CoverStateTP.apply();
         }
@@ -1199,7 +1697,8 @@ void DarkLight_CoverCalibrator::getCoverState()
 
 void DarkLight_CoverCalibrator::getCalibratorState()
 {
-    char GetCalibratorStateResponse[8] = {0};
+    char GetCalibratorStateResponse[DarkLight_Serial::responseSize] = {0};
+    const std::string previousCalibratorState = CalibratorStateTP[0].getText();
     LOG_DEBUG("Get CalibratorState");
     if (!sendCommand("L", GetCalibratorStateResponse))
     {
@@ -1258,6 +1757,7 @@ void DarkLight_CoverCalibrator::getCalibratorState()
             }
             TurnLightSP.apply();
 
+            traceState("light", previousCalibratorState, CalibratorStateTP[0].getText());
             CalibratorStateTP.setState(IPS_IDLE);
             CalibratorStateTP.apply();
         }
@@ -1266,7 +1766,7 @@ void DarkLight_CoverCalibrator::getCalibratorState()
 
 void DarkLight_CoverCalibrator::getBrightness()
 {
-    char BrightnessResponse[8] = {0};
+    char BrightnessResponse[DarkLight_Serial::responseSize] = {0};
     LOG_DEBUG("Getting Brightness");
     //get brightness response
     if (!sendCommand("B", BrightnessResponse))
@@ -1311,7 +1811,7 @@ void DarkLight_CoverCalibrator::setBrightness(double BrightnessValue)
     command += std::to_string(intValue);  //append value
 
     //send command
-    char response[8] = {0};
+    char response[DarkLight_Serial::responseSize] = {0};
     LOG_DEBUG("Setting Brightness");
     if (!sendCommand(command.c_str(), response))
     {
@@ -1326,7 +1826,15 @@ void DarkLight_CoverCalibrator::setBrightness(double BrightnessValue)
 void DarkLight_CoverCalibrator::setAutoHeatOn()
 {
     LOG_DEBUG("Setting autoHeatOn");
-    char AutoHeatOnResponse[8] = {0};
+
+    //firmware that keeps the heater mode restores it after a reset, only send a change
+    if (firmwareSettings && getSettings() && autoHeatOn == (AutoHeatOnSP.findOnSwitchIndex() == Heat_AutoOn))
+    {
+        LOG_DEBUG("AutoHeatOn already set");
+        return;
+    }
+
+    char AutoHeatOnResponse[DarkLight_Serial::responseSize] = {0};
     switch (AutoHeatOnSP.findOnSwitchIndex())
     {
         case Heat_AutoOn:
@@ -1376,7 +1884,15 @@ void DarkLight_CoverCalibrator::setAutoHeatOn()
 void DarkLight_CoverCalibrator::setHeatOnClose()
 {
     LOG_DEBUG("Setting HeatOnClose");
-    char HeatOnCloseResponse[8] = {0};
+
+    //firmware that keeps the heater mode restores it after a reset, only send a change
+    if (firmwareSettings && getSettings() && heatOnClose == (HeatOnCloseSP.findOnSwitchIndex() == Heat_OnClose))
+    {
+        LOG_DEBUG("HeatOnClose already set");
+        return;
+    }
+
+    char HeatOnCloseResponse[DarkLight_Serial::responseSize] = {0};
     switch (HeatOnCloseSP.findOnSwitchIndex())
     {
         case Heat_OnClose:
@@ -1425,7 +1941,8 @@ void DarkLight_CoverCalibrator::setHeatOnClose()
 
 void DarkLight_CoverCalibrator::getHeaterState()
 {
-    char HeaterStateResponse[8] = {0};
+    char HeaterStateResponse[DarkLight_Serial::responseSize] = {0};
+    const std::string previousHeaterState = HeaterStateTP[0].getText();
     LOG_DEBUG("Get HeaterState");
     if (!sendCommand("R", HeaterStateResponse))
     {
@@ -1445,6 +1962,7 @@ void DarkLight_CoverCalibrator::getHeaterState()
         {
             //process the response
             int responseValue = HeaterStateResponse[0] - '0';
+            heaterStateCode = responseValue;
             switch (responseValue)
             {
                 case 0:
@@ -1516,8 +2034,424 @@ void DarkLight_CoverCalibrator::getHeaterState()
             {
                 heatModeIsChanging = false;
             }
+            traceState("heater", previousHeaterState, HeaterStateTP[0].getText());
             HeaterStateTP.apply();
             TurnHeaterSP.apply();
         }
     }
-}//end of getHeaterState
\ No newline at end of file
+}//end of getHeaterState
+
+void DarkLight_CoverCalibrator::getTelemetryInterval()
+{
+    char IntervalResponse[DarkLight_Serial::responseSize] = {0};
+    LOG_DEBUG("Get telemetry interval");
+    if (sendCommand("y", IntervalResponse))
+    {
+        LOGF_DEBUG("Telemetry interval response: %s", IntervalResponse);
+        int interval = atoi(IntervalResponse);
+        //keep the default for firmware without the command
+        if (interval > 0)
+        {
+            telemetryInterval = interval;
+        }
+    }
+}//end of getTelemetryInterval
+
+void DarkLight_CoverCalibrator::getTelemetry()
+{
+    char TelemetryResponse[DarkLight_Serial::responseSize] = {0};
+    LOG_DEBUG("Get telemetry");
+    lastTelemetry = std::chrono::steady_clock::now();
+    if (!sendCommand("Y", TelemetryResponse))
+    {
+        LOG_WARN("Telemetry command failed");
+        HeaterTelemetryNP.setState(IPS_ALERT);
+        HeaterTelemetryNP.apply();
+        return;
+    }
+
+    LOGF_DEBUG("Telemetry response: %s", TelemetryResponse);
+
+    //response is key:value pairs, e.g. h1t:21.5:h1p:40|h2t:na:h2p:na|o:8.2:h:81.0:d:5.1
+    static const struct
+    {
+        const char *key;
+        int index;
+    } telemetryKeys[] =
+    {
+        {"h1t", Heater1_Temp}, {"h1p", Heater1_PWM}, {"h2t", Heater2_Temp}, {"h2p", Heater2_PWM},
+        {"o", Ambient_Temp}, {"h", Ambient_Humidity}, {"d", Dew_Point}
+    };
+
+    int parsed = 0;
+    std::string faults;
+    DarkLight_TelemetryRecord entry = {};
+    char *savePtr = nullptr;
+    char *key = strtok_r(TelemetryResponse, ":|", &savePtr);
+    while (key != nullptr)
+    {
+        char *value = strtok_r(nullptr, ":|", &savePtr);
+        if (value == nullptr)
+        {
+            break;
+        }
+
+        for (const auto &telemetryKey : telemetryKeys)
+        {
+            if (strcmp(key, telemetryKey.key) != 0)
+            {
+                continue;
+            }
+
+            //"na" marks a heater that is not installed and "err" one isolated by a failing probe, leave them out
+            if (strcmp(value, "err") == 0)
+            {
+                faults += faults.empty() ? key : std::string(", ") + key;
+            }
+            else if (strcmp(value, "na") != 0)
+            {
+                HeaterTelemetryNP[telemetryKey.index].setValue(atof(value));
+                entry.values[telemetryKey.index] = static_cast<float>(atof(value));
+                entry.validMask |= 1 << telemetryKey.index;
+                parsed++;
+            }
+        }
+        key = strtok_r(nullptr, ":|", &savePtr);
+    }
+
+    if (faults != telemetryFaults)
+    {
+        if (!faults.empty())
+        {
+            LOGF_WARN("Heater probe fault (%s), that heater is held off while the other keeps running", faults.c_str());
+        }
+        else
+        {
+            LOG_INFO("Heater probes reading normally");
+        }
+        telemetryFaults = faults;
+    }
+
+    HeaterTelemetryNP.setState((parsed > 0 && faults.empty()) ? IPS_OK : IPS_ALERT);
+    HeaterTelemetryNP.apply();
+
+    if (parsed > 0 && telemetryLog.isOpen())
+    {
+        struct timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        entry.timeUs = static_cast<uint64_t>(now.tv_sec) * 1000000 + now.tv_nsec / 1000;
+        entry.heaterState = static_cast<uint8_t>(heaterStateCode);
+        telemetryLog.append(entry);
+    }
+}//end of getTelemetry
+
+void DarkLight_CoverCalibrator::openTelemetryLog()
+{
+    telemetryLog.close();
+    if (TelemetryLogSP[0].getState() != ISS_ON)
+    {
+        TelemetryLogSP.setState(IPS_IDLE);
+    }
+    else if (telemetryLog.open(TelemetryFileTP[0].getText()))
+    {
+        LOGF_DEBUG("Recording heater telemetry to %s", TelemetryFileTP[0].getText());
+        TelemetryLogSP.setState(IPS_OK);
+    }
+    else if (errno == EEXIST)
+    {
+        LOGF_ERROR("%s is not a telemetry log, choose another file, it was left untouched", TelemetryFileTP[0].getText());
+        TelemetryLogSP.setState(IPS_ALERT);
+    }
+    else
+    {
+        LOGF_ERROR("Cannot open telemetry log %s: %s", TelemetryFileTP[0].getText(), strerror(errno));
+        TelemetryLogSP.setState(IPS_ALERT);
+    }
+    TelemetryLogSP.apply();
+}//end of openTelemetryLog
+
+bool DarkLight_CoverCalibrator::getHeaterGains(int heater, INDI::PropertyNumber &gains)
+{
+    char GainsResponse[DarkLight_Serial::responseSize] = {0};
+    char command[4];
+    snprintf(command, sizeof(command), "J%d", heater);
+    LOGF_DEBUG("Get heater %d gains", heater);
+    if (!sendCommand(command, GainsResponse))
+    {
+        return false;
+    }
+
+    LOGF_DEBUG("Heater %d gains response: %s", heater, GainsResponse);
+
+    //reported as kp:ki:kff, '?' when the heater is not installed or the firmware predates the command
+    int kp, ki, kff;
+    if (sscanf(GainsResponse, "%d:%d:%d", &kp, &ki, &kff) != 3)
+    {
+        return false;
+    }
+
+    gains[Gain_Kp].setValue(kp);
+    gains[Gain_Ki].setValue(ki);
+    gains[Gain_Kff].setValue(kff);
+    gains.setState(IPS_OK);
+    return true;
+}//end of getHeaterGains
+
+void DarkLight_CoverCalibrator::setHeaterGains(int heater, INDI::PropertyNumber &gains)
+{
+    static const char gainLetters[] = {'P', 'I', 'F'};
+    bool ok = true;
+    for (int i = Gain_Kp; i <= Gain_Kff; i++)
+    {
+        char GainsResponse[DarkLight_Serial::responseSize] = {0};
+        char command[12];
+        snprintf(command, sizeof(command), "J%d%c%d", heater, gainLetters[i], static_cast<int>(gains[i].getValue()));
+        LOGF_DEBUG("Set heater %d gain: %s", heater, command);
+        if (!sendCommand(command, GainsResponse))
+        {
+            LOGF_ERROR("Heater %d gains ERROR", heater);
+            ok = false;
+            break;
+        }
+    }
+
+    //show what the firmware stored
+    if (!getHeaterGains(heater, gains) || !ok)
+    {
+        gains.setState(IPS_ALERT);
+    }
+    else
+    {
+        LOGF_INFO("Heater %d gains set to Kp %.0f, Ki %.0f, Kff %.0f", heater, gains[Gain_Kp].getValue(),
+                  gains[Gain_Ki].getValue(), gains[Gain_Kff].getValue());
+    }
+    gains.apply();
+}//end of setHeaterGains
+
+bool DarkLight_CoverCalibrator::getProbeResolution()
+{
+    char ResolutionResponse[DarkLight_Serial::responseSize] = {0};
+    LOG_DEBUG("Get heater probe resolution");
+    if (!sendCommand("N", ResolutionResponse))
+    {
+        return false;
+    }
+
+    LOGF_DEBUG("Heater probe resolution response: %s", ResolutionResponse);
+
+    //'?' when the firmware predates the command
+    int bits = atoi(ResolutionResponse);
+    if (bits < 9 || bits > 12)
+    {
+        return false;
+    }
+
+    ProbeResolutionNP[0].setValue(bits);
+    ProbeResolutionNP.setState(IPS_OK);
+    return true;
+}//end of getProbeResolution
+
+void DarkLight_CoverCalibrator::setProbeResolution()
+{
+    char ResolutionResponse[DarkLight_Serial::responseSize] = {0};
+    char command[8];
+    snprintf(command, sizeof(command), "N%d", static_cast<int>(ProbeResolutionNP[0].getValue()));
+    LOGF_DEBUG("Set heater probe resolution: %s", command);
+    bool ok = sendCommand(command, ResolutionResponse);
+    if (!ok)
+    {
+        LOG_ERROR("Heater probe resolution ERROR");
+    }
+
+    //show what the firmware stored
+    if (!getProbeResolution() || !ok)
+    {
+        ProbeResolutionNP.setState(IPS_ALERT);
+    }
+    else
+    {
+        LOGF_INFO("Heater probe resolution set to %.0f bits", ProbeResolutionNP[0].getValue());
+    }
+    ProbeResolutionNP.apply();
+}//end of setProbeResolution
+
+bool DarkLight_CoverCalibrator::getSettings()
+{
+    char SettingsResponse[DarkLight_Serial::responseSize] = {0};
+    LOG_DEBUG("Get firmware settings");
+    if (!sendCommand("X", SettingsResponse))
+    {
+        return false;
+    }
+
+    LOGF_DEBUG("Firmware settings response: %s", SettingsResponse);
+
+    //reported as key:value pairs, na for features that are not installed, '?' when the firmware predates the command
+    char *savePtr = nullptr;
+    int found = 0;
+    for (char *key = strtok_r(SettingsResponse, ":", &savePtr); key != nullptr; key = strtok_r(nullptr, ":", &savePtr))
+    {
+        char *value = strtok_r(nullptr, ":", &savePtr);
+        if (value == nullptr)
+        {
+            break;
+        }
+        found++;
+        if (strcmp(value, "na") == 0)
+        {
+            continue;
+        }
+
+        if (strcmp(key, "mt") == 0)
+        {
+            SettingsNP[Setting_MoveTime].setValue(atof(value));
+        }
+        else if (strcmp(key, "dp") == 0)
+        {
+            SettingsNP[Setting_DeltaPoint].setValue(atof(value));
+        }
+        else if (strcmp(key, "hs") == 0)
+        {
+            SettingsNP[Setting_HeatShutoff].setValue(atof(value));
+        }
+        else if (strcmp(key, "ah") == 0)
+        {
+            autoHeatOn = (atoi(value) == 1);
+        }
+        else if (strcmp(key, "hc") == 0)
+        {
+            heatOnClose = (atoi(value) == 1);
+        }
+    }
+
+    if (found == 0)
+    {
+        return false;
+    }
+
+    SettingsNP.setState(IPS_OK);
+    return true;
+}//end of getSettings
+
+void DarkLight_CoverCalibrator::setSettings()
+{
+    //only settings of installed features are accepted
+    std::vector<std::string> commands;
+    if (CoverStateTP[0].getText() != std::string("Not Present"))
+    {
+        commands.push_back("Xmt" + std::to_string(static_cast<int>(SettingsNP[Setting_MoveTime].getValue())));
+    }
+    if (HeaterStateTP[0].getText() != std::string("Not Present"))
+    {
+        char deltaPoint[12];
+        snprintf(deltaPoint, sizeof(deltaPoint), "Xdp%.1f", SettingsNP[Setting_DeltaPoint].getValue());
+        commands.push_back(deltaPoint);
+        commands.push_back("Xhs" + std::to_string(static_cast<int>(SettingsNP[Setting_HeatShutoff].getValue())));
+    }
+
+    bool ok = true;
+    for (const std::string &command : commands)
+    {
+        char SettingsResponse[DarkLight_Serial::responseSize] = {0};
+        LOGF_DEBUG("Set firmware setting: %s", command.c_str());
+        if (!sendCommand(command.c_str(), SettingsResponse) || SettingsResponse[0] == '?')
+        {
+            //a cover move in progress keeps its move time
+            LOGF_WARN("Firmware setting %s was not accepted", command.c_str() + 1);
+            ok = false;
+        }
+    }
+
+    //show what the firmware stored
+    if (!getSettings() || !ok)
+    {
+        SettingsNP.setState(IPS_ALERT);
+    }
+    else
+    {
+        LOG_INFO("Firmware settings saved");
+    }
+    SettingsNP.apply();
+}//end of setSettings
+
+void DarkLight_CoverCalibrator::startAutotune(int heater)
+{
+    char AutotuneResponse[DarkLight_Serial::responseSize] = {0};
+    char command[4];
+    snprintf(command, sizeof(command), "U%d", heater);
+    LOGF_DEBUG("Start heater %d auto-tune", heater);
+    if (!sendCommand(command, AutotuneResponse) || AutotuneResponse[0] == '?')
+    {
+        LOGF_ERROR("Heater %d auto-tune could not start, check the heater is installed and not in error", heater);
+        return;
+    }
+
+    LOGF_INFO("Heater %d auto-tune started, this can take up to 30 minutes", heater);
+}//end of startAutotune
+
+bool DarkLight_CoverCalibrator::getAutotune()
+{
+    char AutotuneResponse[DarkLight_Serial::responseSize] = {0};
+    LOG_DEBUG("Get auto-tune");
+    if (!sendCommand("U", AutotuneResponse))
+    {
+        return false;
+    }
+
+    LOGF_DEBUG("Auto-tune response: %s", AutotuneResponse);
+
+    //reported as status:heater:cycles:kp:ki:kff, status 0:Idle, 1:Running, 2:Done, 3:Failed
+    int status, heater, cycles, kp, ki, kff;
+    if (sscanf(AutotuneResponse, "%d:%d:%d:%d:%d:%d", &status, &heater, &cycles, &kp, &ki, &kff) != 6)
+    {
+        return false;
+    }
+
+    const bool wasRunning = autotuneRunning;
+    autotuneRunning = (status == 1);
+
+    char statusText[MAXINDINAME];
+    switch (status)
+    {
+        case 1:
+            snprintf(statusText, sizeof(statusText), "Heater %d: cycle %d", heater, cycles);
+            AutotuneStatusTP.setState(IPS_BUSY);
+            break;
+        case 2:
+            snprintf(statusText, sizeof(statusText), "Heater %d: Kp %d, Ki %d, Kff %d", heater, kp, ki, kff);
+            AutotuneStatusTP.setState(IPS_OK);
+            break;
+        case 3:
+            snprintf(statusText, sizeof(statusText), "Heater %d: Failed", heater);
+            AutotuneStatusTP.setState(IPS_ALERT);
+            break;
+        default:
+            snprintf(statusText, sizeof(statusText), "Idle");
+            AutotuneStatusTP.setState(IPS_IDLE);
+            break;
+    }
+    AutotuneStatusTP[0].setText(statusText);
+    AutotuneStatusTP.apply();
+
+    //show the new gains once a run finishes
+    if (wasRunning && !autotuneRunning)
+    {
+        if (status == 2)
+        {
+            LOGF_INFO("Heater %d auto-tune complete: Kp %d, Ki %d, Kff %d", heater, kp, ki, kff);
+        }
+        else
+        {
+            LOGF_WARN("Heater %d auto-tune did not complete", heater);
+        }
+
+        INDI::PropertyNumber &gains = (heater == 1) ? HeaterOneGainsNP : HeaterTwoGainsNP;
+        if (getHeaterGains(heater, gains))
+        {
+            gains.apply();
+        }
+        heatModeIsChanging = true;
+    }
+
+    return true;
+}//end of getAutotune
@@ -41,6 +41,11 @@ For more information, please refer to the full terms of the Creative Commons Att
 #pragma once
 
 #include "libindi/defaultdevice.h"
+#include "darklight_serial.h"
+#include "darklight_telemetry.h"
+
+#include <string>
+#include <chrono>
 
 namespace Connection
 {
@@ -50,7 +55,7 @@ class Serial;
 class DarkLight_CoverCalibrator : public INDI::DefaultDevice
 {
     public:
-        DarkLight_CoverCalibrator();
+        explicit DarkLight_CoverCalibrator(int unit = 1);
         virtual ~DarkLight_CoverCalibrator() override = default;
 
         virtual const char *getDefaultName() override;
@@ -62,12 +67,18 @@ class DarkLight_CoverCalibrator : public INDI::DefaultDevice
 
         //serial communications
         bool Handshake();
-        bool sendCommand(const char *command, const char *response);
-        int PortFD{-1};
+        bool sendCommand(const char *command, const char *response, int timeoutMs = 5000, int maxRetries = 3,
+                         bool quiet = false);
+        DarkLight_Serial transport {this};
+
+        //unit number when several DLCs are managed by one driver process
+        int unitNumber {1};
+        std::string defaultName;
 
         Connection::Serial *serialConnection{nullptr};
 
         bool mainValues();
+        void syncLightSettings();
         void setStabilizeTime();
         void setAutoOn();
         void setLightDisabled();
@@ -79,6 +90,20 @@ class DarkLight_CoverCalibrator : public INDI::DefaultDevice
         void setHeatOnClose();
         void setHeaterState();
         void getHeaterState();
+        void getTelemetryInterval();
+        void getTelemetry();
+        void openTelemetryLog();
+        bool getHeaterGains(int heater, INDI::PropertyNumber &gains);
+        void setHeaterGains(int heater, INDI::PropertyNumber &gains);
+        bool getProbeResolution();
+        void setProbeResolution();
+        bool getSettings();
+        void setSettings();
+        bool getAutotune();
+        void startAutotune(int heater);
+        void updateDiagnostics();
+        bool getMemoryWear();
+        void traceState(const char *name, const std::string &previous, const char *current);
         bool lightDisabled;
         bool coverIsMoving;
         bool lightIsReady;
@@ -86,6 +111,15 @@ class DarkLight_CoverCalibrator : public INDI::DefaultDevice
         bool autoHeatOn;
         bool heatOnClose;
         bool heatModeIsChanging;
+        int telemetryInterval {2000}; //(ms) firmware dewInterval, telemetry is not polled faster
+        std::chrono::steady_clock::time_point lastTelemetry;
+        int heaterStateCode {0}; //last 'R' reply, stored with each telemetry record
+        bool firmwareSettings {false}; //firmware answers X and keeps its settings, heater modes included, in memory
+        bool memoryWear {false}; //firmware answers m with its EEPROM write counts
+        std::chrono::steady_clock::time_point lastMemoryWear;
+        bool autotuneRunning {false};
+        std::string telemetryFaults; //keys the firmware last reported as "err"
+        DarkLight_TelemetryLog telemetryLog;
 
         //define properties
         //----- generic -----
@@ -122,7 +156,35 @@ class DarkLight_CoverCalibrator : public INDI::DefaultDevice
         INDI::PropertyText HeaterStateTP {1};
         INDI::PropertySwitch TurnHeaterSP {4};
         enum {Heat_On, Heat_Off, Heat_Auto, Heat_At_Close};
-        
+        INDI::PropertyNumber HeaterTelemetryNP {7};
+        enum {Heater1_Temp, Heater1_PWM, Heater2_Temp, Heater2_PWM, Ambient_Temp, Ambient_Humidity, Dew_Point};
+        INDI::PropertyNumber HeaterOneGainsNP {3};
+        INDI::PropertyNumber HeaterTwoGainsNP {3};
+        enum {Gain_Kp, Gain_Ki, Gain_Kff};
+        INDI::PropertyNumber ProbeResolutionNP {1};
+        INDI::PropertyNumber SettingsNP {3};
+        enum {Setting_MoveTime, Setting_DeltaPoint, Setting_HeatShutoff};
+        INDI::PropertySwitch AutotuneSP {3};
+        enum {Autotune_Heater1, Autotune_Heater2, Autotune_Abort};
+        INDI::PropertyText AutotuneStatusTP {1};
+        INDI::PropertySwitch TelemetryLogSP {1};
+        INDI::PropertyText TelemetryFileTP {1};
+
+        //----- diagnostics -----
+        INDI::PropertyNumber SerialStatsNP {7};
+        enum {Stats_Commands, Stats_Failures, Stats_Timeouts, Stats_Retries, Stats_ReadErrors, Stats_BytesWritten, Stats_BytesRead};
+        INDI::PropertyNumber LatencyNP {4};
+        enum {Latency_P50, Latency_P95, Latency_P99, Latency_Max};
+        INDI::PropertyText OpcodeStatsTP {0};
+        INDI::PropertySwitch ResetStatsSP {1};
+        INDI::PropertySwitch StatsCSVSP {1};
+        INDI::PropertyText StatsFileTP {1};
+        INDI::PropertySwitch TraceSP {2};
+        enum {Trace_Enable, Trace_Dump};
+        INDI::PropertyText TraceFileTP {1};
+        INDI::PropertyNumber MemoryWearNP {6};
+        enum {Wear_CoverWrites, Wear_PanelWrites, Wear_SettingsWrites, Wear_Wraps, Wear_CyclesPerDay, Wear_YearsLeft};
+
     protected:
         virtual bool saveConfigItems(FILE *fp) override;
 };
@@ -0,0 +1,371 @@
+/*******************************************************************
+Creative Commons Attribution-NonCommercial License
+
+Copyright © 2020-2025 Nathan Woelfle
+
+This work is licensed under a Creative Commons Attribution-NonCommercial 4.0 International License.
+
+You are free to:
+
+    Share — copy and redistribute the material in any medium or format
+    Adapt — remix, transform, and build upon the material
+
+Under the following conditions:
+
+    Attribution — You must give appropriate credit, provide a link to the license, and indicate if changes were made. You may do so in any reasonable manner, but not in any way that suggests the licensor endorses you or your use.
+    NonCommercial — You may not use the material for commercial purposes.
+    No additional restrictions — You may not apply legal terms or technological measures that legally restrict others from doing anything the license permits.
+
+Notices:
+
+    You may not use this work for commercial purposes without written permission from the copyright holder.
+    This work is provided "as is" without warranty of any kind, either express or implied, including but not limited to the warranties of merchantability, fitness for a particular purpose, and noninfringement. In no event shall the authors or copyright holders be liable for any claim, damages, or other liability, whether in an action of contract, tort, or otherwise, arising from, out of, or in connection with the software or the use or other dealings in the software.
+
+Scope:
+
+    This license applies to both the hardware and software components of the DarkLight Cover Calibrator.
+
+Modified Versions:
+
+    You are permitted to create modified versions of the DarkLight Cover Calibrator for non-commercial use, provided that you:
+        Retain the original copyright notice and license terms.
+        Include a clear reference to the original creator (Nathan Woelfle) and provide a link to the original work.
+
+Jurisdiction:
+
+    This license is governed by the laws of the United States of America, and by international copyright laws and treaties.
+
+For more information, please refer to the full terms of the Creative Commons Attribution-NonCommercial 4.0 International License: https://creativecommons.org/licenses/by-nc/4.0/
+*******************************************************************/
+
+#include "darklight_serial.h"
+#include "indicom.h"
+#include <termios.h>
+#include <cstring>
+#include <cerrno>
+#include <cmath>
+#include <chrono>
+#include <ctime>
+#include <algorithm>
+#include <sys/select.h>
+#include <unistd.h>
+
+static const double latencyBucketBaseMs = 0.1;
+static const double latencyBucketGrowth = 1.25;
+
+void DarkLight_CommandStats::recordLatency(double latencyMs)
+{
+    int bucket = 0;
+    if (latencyMs > latencyBucketBaseMs)
+    {
+        bucket = static_cast<int>(std::ceil(std::log(latencyMs / latencyBucketBaseMs) / std::log(latencyBucketGrowth)));
+    }
+    latencyBuckets[std::min(bucket, latencyBucketCount - 1)]++;
+    maxLatencyMs = std::max(maxLatencyMs, latencyMs);
+}
+
+double DarkLight_CommandStats::percentile(double fraction) const
+{
+    uint32_t samples = 0;
+    for (int i = 0; i < latencyBucketCount; i++)
+    {
+        samples += latencyBuckets[i];
+    }
+    if (samples == 0)
+    {
+        return 0;
+    }
+
+    //report the upper edge of the bucket holding the requested sample, never above the real max
+    const double target = fraction * samples;
+    uint32_t cumulative = 0;
+    for (int i = 0; i < latencyBucketCount; i++)
+    {
+        cumulative += latencyBuckets[i];
+        if (cumulative >= target)
+        {
+            return std::min(maxLatencyMs, latencyBucketBaseMs * std::pow(latencyBucketGrowth, i));
+        }
+    }
+    return maxLatencyMs;
+}
+
+void DarkLight_CommandStats::add(const DarkLight_CommandStats &other)
+{
+    count += other.count;
+    failures += other.failures;
+    timeouts += other.timeouts;
+    retries += other.retries;
+    readErrors += other.readErrors;
+    bytesWritten += other.bytesWritten;
+    bytesRead += other.bytesRead;
+    maxLatencyMs = std::max(maxLatencyMs, other.maxLatencyMs);
+    for (int i = 0; i < latencyBucketCount; i++)
+    {
+        latencyBuckets[i] += other.latencyBuckets[i];
+    }
+}
+
+DarkLight_Serial::DarkLight_Serial(INDI::DefaultDevice *device) : device(device)
+{
+    commandBuffer.reserve(16);
+}
+
+void DarkLight_Serial::setPortFD(int fd)
+{
+    std::lock_guard<std::mutex> lock(portMutex);
+    PortFD = fd;
+}
+
+int DarkLight_Serial::getPortFD() const
+{
+    return PortFD;
+}
+
+bool DarkLight_Serial::sendCommand(const char *command, char *response, int timeoutMs, int maxRetries, bool quiet)
+{
+    std::lock_guard<std::mutex> lock(portMutex); //only this unit's port is locked
+
+    if (PortFD == -1)
+    {
+        return false; //cannot send if port is not open
+    }
+
+    const char *deviceName = device->getDeviceName();
+    const int failureLevel = quiet ? INDI::Logger::DBG_DEBUG : INDI::Logger::DBG_ERROR;
+    int nbytes_written = 0, tty_rc = 0;
+
+    DarkLight_CommandStats &stats = opcodeStats[static_cast<unsigned char>(command[0]) % opcodeCount];
+    stats.count++;
+    const auto startTime = std::chrono::steady_clock::now();
+
+    //retry a maximum of maxRetries times
+    int retryCount = 0;
+
+    //form the command
+    commandBuffer = "<";
+    commandBuffer += command;
+    commandBuffer += ">";
+
+    DEBUGFDEVICE(deviceName, INDI::Logger::DBG_DEBUG, "Sending command: %s", commandBuffer.c_str());
+
+    do
+    {
+        //use a loop with select to monitor the serial port with a timeout
+        while (true)
+        {
+            tcflush(PortFD, TCIOFLUSH);
+            if ((tty_rc = tty_write_string(PortFD, commandBuffer.c_str(), &nbytes_written)) != TTY_OK)
+            {
+                char errorMessage[MAXRBUF];
+                tty_error_msg(tty_rc, errorMessage, MAXRBUF);
+                DEBUGFDEVICE(deviceName, INDI::Logger::DBG_ERROR, "Serial write error: %s", errorMessage);
+                trace.record(TRACE_ERROR, commandBuffer.data(), commandBuffer.size());
+                stats.failures++;
+                return false;
+            }
+            stats.bytesWritten += nbytes_written;
+            trace.record(TRACE_TX, commandBuffer.data(), commandBuffer.size());
+
+            int frameLength = 0;
+            FrameResult frameResult = readFrame(timeoutMs, frameLength);
+            if (frameResult == FRAME_OK)
+            {
+                trace.record(TRACE_RX, readBuffer, frameLength);
+                stats.bytesRead += frameLength;
+                stats.recordLatency(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() -
+                                    startTime).count());
+
+                //response received successfully
+                DEBUGFDEVICE(deviceName, INDI::Logger::DBG_DEBUG, "Response received: %s", readBuffer);
+
+                //copy what is between the markers back to the caller's buffer
+                memcpy(response, readBuffer + 1, frameLength - 2);
+                response[frameLength - 2] = '\0';
+                return true; //success
+            }
+            else if (frameResult == FRAME_TIMEOUT)
+            {
+                DEBUGDEVICE(deviceName, failureLevel, "Serial read timed out");
+                trace.record(TRACE_TIMEOUT, commandBuffer.data(), commandBuffer.size());
+                stats.timeouts++;
+                break; //exit the inner loop and try again (retry)
+            }
+            else if (frameResult == FRAME_OVERFLOW)
+            {
+                DEBUGFDEVICE(deviceName, INDI::Logger::DBG_ERROR, "Serial read error: response too long: %s", readBuffer);
+                trace.record(TRACE_ERROR, commandBuffer.data(), commandBuffer.size());
+                stats.readErrors++;
+                break; //counts as an attempt like a timeout, a device that keeps overflowing fails out
+            }
+            else
+            {
+                DEBUGFDEVICE(deviceName, INDI::Logger::DBG_ERROR, "Serial read error: %s", strerror(errno));
+                trace.record(TRACE_ERROR, commandBuffer.data(), commandBuffer.size());
+                stats.failures++;
+                return false;
+            }
+        }
+
+        //increment the retry count
+        retryCount++;
+        if (retryCount < maxRetries)
+        {
+            stats.retries++;
+        }
+    }
+    while (retryCount < maxRetries);
+
+    DEBUGDEVICE(deviceName, failureLevel, "Maximum retry attempts reached. Transmission failed.");
+    stats.failures++;
+    return false; // Error
+}//end of sendCommand
+
+DarkLight_Serial::FrameResult DarkLight_Serial::readFrame(int timeoutMs, int &frameLength)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    bool inFrame = false;
+    frameLength = 0;
+
+    while (true)
+    {
+        auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0)
+        {
+            return FRAME_TIMEOUT;
+        }
+
+        struct timeval timeout;
+        timeout.tv_sec = remaining.count() / 1000000;
+        timeout.tv_usec = remaining.count() % 1000000;
+
+        fd_set readfds;
+        FD_ZERO(&readfds);
+        FD_SET(PortFD, &readfds);
+
+        int selectResult = select(PortFD + 1, &readfds, nullptr, nullptr, &timeout);
+        if (selectResult == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return FRAME_ERROR;
+        }
+        else if (selectResult == 0)
+        {
+            return FRAME_TIMEOUT;
+        }
+
+        //take whatever has arrived and scan it for the frame markers
+        char chunk[responseSize];
+        ssize_t nbytes = read(PortFD, chunk, sizeof(chunk));
+        if (nbytes <= 0)
+        {
+            if (nbytes < 0 && (errno == EINTR || errno == EAGAIN))
+            {
+                continue;
+            }
+            return FRAME_ERROR;
+        }
+
+        for (ssize_t i = 0; i < nbytes; i++)
+        {
+            if (chunk[i] == '<')
+            {
+                //a start marker always begins a new frame, same as the firmware
+                inFrame = true;
+                frameLength = 0;
+            }
+            else if (!inFrame)
+            {
+                continue; //noise before the start marker
+            }
+
+            if (frameLength >= responseSize - 1)
+            {
+                readBuffer[frameLength] = '\0';
+                return FRAME_OVERFLOW;
+            }
+
+            readBuffer[frameLength++] = chunk[i];
+            if (chunk[i] == '>')
+            {
+                readBuffer[frameLength] = '\0';
+                return FRAME_OK;
+            }
+        }
+    }
+}//end of readFrame
+
+DarkLight_Trace &DarkLight_Serial::getTrace()
+{
+    return trace;
+}
+
+const DarkLight_CommandStats &DarkLight_Serial::getStats(char opcode) const
+{
+    return opcodeStats[static_cast<unsigned char>(opcode) % opcodeCount];
+}
+
+DarkLight_CommandStats DarkLight_Serial::getTotals() const
+{
+    DarkLight_CommandStats totals;
+    for (int i = 0; i < opcodeCount; i++)
+    {
+        totals.add(opcodeStats[i]);
+    }
+    return totals;
+}
+
+void DarkLight_Serial::resetStats()
+{
+    std::lock_guard<std::mutex> lock(portMutex);
+    for (int i = 0; i < opcodeCount; i++)
+    {
+        opcodeStats[i] = DarkLight_CommandStats();
+    }
+}
+
+bool DarkLight_Serial::writeStatsCSV(const char *fileName) const
+{
+    FILE *fp = fopen(fileName, "a");
+    if (fp == nullptr)
+    {
+        DEBUGFDEVICE(device->getDeviceName(), INDI::Logger::DBG_ERROR, "Cannot open %s: %s", fileName, strerror(errno));
+        return false;
+    }
+
+    //write header only for a new file so sessions from several nights can be appended
+    fseek(fp, 0, SEEK_END);
+    if (ftell(fp) == 0)
+    {
+        fprintf(fp, "time,device,opcode,count,failures,timeouts,retries,read_errors,bytes_written,bytes_read,"
+                "p50_ms,p95_ms,p99_ms,max_ms\n");
+    }
+
+    char timeStamp[32];
+    time_t now = time(nullptr);
+    strftime(timeStamp, sizeof(timeStamp), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+    auto writeRow = [&](const char *opcode, const DarkLight_CommandStats &stats)
+    {
+        fprintf(fp, "%s,%s,%s,%u,%u,%u,%u,%u,%llu,%llu,%.1f,%.1f,%.1f,%.1f\n", timeStamp, device->getDeviceName(), opcode,
+                stats.count, stats.failures, stats.timeouts, stats.retries, stats.readErrors,
+                static_cast<unsigned long long>(stats.bytesWritten), static_cast<unsigned long long>(stats.bytesRead),
+                stats.percentile(0.50), stats.percentile(0.95), stats.percentile(0.99), stats.maxLatencyMs);
+    };
+
+    for (int i = 0; i < opcodeCount; i++)
+    {
+        if (opcodeStats[i].count > 0)
+        {
+            char opcode[2] = {static_cast<char>(i), '\0'};
+            writeRow(opcode, opcodeStats[i]);
+        }
+    }
+    writeRow("all", getTotals());
+
+    fclose(fp);
+    return true;
+}//end of writeStatsCSV
@@ -0,0 +1,112 @@
+/*******************************************************************
+Creative Commons Attribution-NonCommercial License
+
+Copyright © 2020-2025 Nathan Woelfle
+
+This work is licensed under a Creative Commons Attribution-NonCommercial 4.0 International License.
+
+You are free to:
+
+    Share — copy and redistribute the material in any medium or format
+    Adapt — remix, transform, and build upon the material
+
+Under the following conditions:
+
+    Attribution — You must give appropriate credit, provide a link to the license, and indicate if changes were made. You may do so in any reasonable manner, but not in any way that suggests the licensor endorses you or your use.
+    NonCommercial — You may not use the material for commercial purposes.
+    No additional restrictions — You may not apply legal terms or technological measures that legally restrict others from doing anything the license permits.
+
+Notices:
+
+    You may not use this work for commercial purposes without written permission from the copyright holder.
+    This work is provided "as is" without warranty of any kind, either express or implied, including but not limited to the warranties of merchantability, fitness for a particular purpose, and noninfringement. In no event shall the authors or copyright holders be liable for any claim, damages, or other liability, whether in an action of contract, tort, or otherwise, arising from, out of, or in connection with the software or the use or other dealings in the software.
+
+Scope:
+
+    This license applies to both the hardware and software components of the DarkLight Cover Calibrator.
+
+Modified Versions:
+
+    You are permitted to create modified versions of the DarkLight Cover Calibrator for non-commercial use, provided that you:
+        Retain the original copyright notice and license terms.
+        Include a clear reference to the original creator (Nathan Woelfle) and provide a link to the original work.
+
+Jurisdiction:
+
+    This license is governed by the laws of the United States of America, and by international copyright laws and treaties.
+
+For more information, please refer to the full terms of the Creative Commons Attribution-NonCommercial 4.0 International License: https://creativecommons.org/licenses/by-nc/4.0/
+*******************************************************************/
+
+#pragma once
+
+#include "libindi/defaultdevice.h"
+#include "darklight_trace.h"
+
+#include <mutex>
+#include <string>
+#include <cstdint>
+#include <cstdio>
+
+//counters and latency histogram for one command opcode
+struct DarkLight_CommandStats
+{
+    //bucket i holds latencies up to 0.1 ms * 1.25^i, the last one everything above
+    static const int latencyBucketCount = 56;
+
+    uint32_t count {0};
+    uint32_t failures {0};
+    uint32_t timeouts {0};
+    uint32_t retries {0};
+    uint32_t readErrors {0};
+    uint64_t bytesWritten {0};
+    uint64_t bytesRead {0};
+    double maxLatencyMs {0};
+    uint32_t latencyBuckets[latencyBucketCount] {0};
+
+    void recordLatency(double latencyMs);
+    double percentile(double fraction) const;
+    void add(const DarkLight_CommandStats &other);
+};
+
+//serial transport for one DLC unit, owns the port, its lock and its buffers
+class DarkLight_Serial
+{
+    public:
+        //largest frame the firmware sends, including the markers, size caller response buffers with it
+        static const int responseSize = 80;
+
+        explicit DarkLight_Serial(INDI::DefaultDevice *device);
+
+        void setPortFD(int fd);
+        int getPortFD() const;
+
+        //send <command> and copy the reply between the markers into response (responseSize bytes)
+        bool sendCommand(const char *command, char *response, int timeoutMs, int maxRetries, bool quiet);
+
+        //statistics since the last reset, indexed by the command's first character
+        const DarkLight_CommandStats &getStats(char opcode) const;
+        DarkLight_CommandStats getTotals() const;
+        void resetStats();
+        bool writeStatsCSV(const char *fileName) const;
+
+        DarkLight_Trace &getTrace();
+
+    private:
+        enum FrameResult {FRAME_OK, FRAME_TIMEOUT, FRAME_ERROR, FRAME_OVERFLOW};
+        //read one <...> frame into readBuffer, skipping anything before the start marker
+        FrameResult readFrame(int timeoutMs, int &frameLength);
+
+        DarkLight_Trace trace;
+
+        static const int opcodeCount = 128;
+        DarkLight_CommandStats opcodeStats[opcodeCount];
+
+        INDI::DefaultDevice *device {nullptr};
+        int PortFD {-1};
+        std::mutex portMutex;
+
+        //reused between commands to avoid allocating on every transaction
+        std::string commandBuffer;
+        char readBuffer[responseSize] {0};
+};
@@ -0,0 +1,156 @@
+/*******************************************************************
+Creative Commons Attribution-NonCommercial License
+
+Copyright © 2020-2025 Nathan Woelfle
+
+This work is licensed under a Creative Commons Attribution-NonCommercial 4.0 International License.
+
+You are free to:
+
+    Share — copy and redistribute the material in any medium or format
+    Adapt — remix, transform, and build upon the material
+
+Under the following conditions:
+
+    Attribution — You must give appropriate credit, provide a link to the license, and indicate if changes were made. You may do so in any reasonable manner, but not in any way that suggests the licensor endorses you or your use.
+    NonCommercial — You may not use the material for commercial purposes.
+    No additional restrictions — You may not apply legal terms or technological measures that legally restrict others from doing anything the license permits.
+
+Notices:
+
+    You may not use this work for commercial purposes without written permission from the copyright holder.
+    This work is provided "as is" without warranty of any kind, either express or implied, including but not limited to the warranties of merchantability, fitness for a particular purpose, and noninfringement. In no event shall the authors or copyright holders be liable for any claim, damages, or other liability, whether in an action of contract, tort, or otherwise, arising from, out of, or in connection with the software or the use or other dealings in the software.
+
+Scope:
+
+    This license applies to both the hardware and software components of the DarkLight Cover Calibrator.
+
+Modified Versions:
+
+    You are permitted to create modified versions of the DarkLight Cover Calibrator for non-commercial use, provided that you:
+        Retain the original copyright notice and license terms.
+        Include a clear reference to the original creator (Nathan Woelfle) and provide a link to the original work.
+
+Jurisdiction:
+
+    This license is governed by the laws of the United States of America, and by international copyright laws and treaties.
+
+For more information, please refer to the full terms of the Creative Commons Attribution-NonCommercial 4.0 International License: https://creativecommons.org/licenses/by-nc/4.0/
+*******************************************************************/
+
+#include "darklight_telemetry.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+DarkLight_TelemetryLog::~DarkLight_TelemetryLog()
+{
+    close();
+}
+
+bool DarkLight_TelemetryLog::open(const char *name, uint64_t capacity)
+{
+    close();
+
+    int fd = ::open(name, O_RDWR | O_CREAT, 0644);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    //an empty file (or one just created) becomes a new log, anything else must already be one
+    struct stat fileStat;
+    DarkLight_TelemetryHeader existing;
+    if (fstat(fd, &fileStat) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    if (fileStat.st_size != 0 && (pread(fd, &existing, sizeof(existing), 0) != sizeof(existing) ||
+                                  memcmp(existing.magic, "DLCTELEM", sizeof(existing.magic)) != 0))
+    {
+        //not ours, left untouched
+        ::close(fd);
+        errno = EEXIST;
+        return false;
+    }
+
+    //continue an existing log when its layout matches, one of another version or record size starts over
+    bool reuse = fileStat.st_size != 0 && existing.version == fileVersion &&
+                 existing.recordSize == sizeof(DarkLight_TelemetryRecord) && existing.capacity > 0;
+    if (reuse)
+    {
+        capacity = existing.capacity;
+    }
+
+    const size_t size = sizeof(DarkLight_TelemetryHeader) + capacity * sizeof(DarkLight_TelemetryRecord);
+    if (static_cast<size_t>(fileStat.st_size) != size && ftruncate(fd, size) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    void *mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        return false;
+    }
+
+    map = mapped;
+    mapSize = size;
+    header = static_cast<DarkLight_TelemetryHeader *>(map);
+    records = reinterpret_cast<DarkLight_TelemetryRecord *>(header + 1);
+    fileName = name;
+
+    if (!reuse)
+    {
+        memcpy(header->magic, "DLCTELEM", sizeof(header->magic));
+        header->version = fileVersion;
+        header->recordSize = sizeof(DarkLight_TelemetryRecord);
+        header->capacity = capacity;
+        header->head = 0;
+    }
+
+    return true;
+}
+
+void DarkLight_TelemetryLog::close()
+{
+    if (map != nullptr)
+    {
+        msync(map, mapSize, MS_ASYNC);
+        munmap(map, mapSize);
+    }
+    map = nullptr;
+    mapSize = 0;
+    header = nullptr;
+    records = nullptr;
+    fileName.clear();
+}
+
+bool DarkLight_TelemetryLog::isOpen() const
+{
+    return map != nullptr;
+}
+
+const std::string &DarkLight_TelemetryLog::getFileName() const
+{
+    return fileName;
+}
+
+void DarkLight_TelemetryLog::append(const DarkLight_TelemetryRecord &entry)
+{
+    if (header == nullptr)
+    {
+        return;
+    }
+
+    //write the record before publishing it through head so a reader never sees a partial one
+    records[header->head % header->capacity] = entry;
+    __atomic_store_n(&header->head, header->head + 1, __ATOMIC_RELEASE);
+}
@@ -0,0 +1,113 @@
+/*******************************************************************
+Creative Commons Attribution-NonCommercial License
+
+Copyright © 2020-2025 Nathan Woelfle
+
+This work is licensed under a Creative Commons Attribution-NonCommercial 4.0 International License.
+
+You are free to:
+
+    Share — copy and redistribute the material in any medium or format
+    Adapt — remix, transform, and build upon the material
+
+Under the following conditions:
+
+    Attribution — You must give appropriate credit, provide a link to the license, and indicate if changes were made. You may do so in any reasonable manner, but not in any way that suggests the licensor endorses you or your use.
+    NonCommercial — You may not use the material for commercial purposes.
+    No additional restrictions — You may not apply legal terms or technological measures that legally restrict others from doing anything the license permits.
+
+Notices:
+
+    You may not use this work for commercial purposes without written permission from the copyright holder.
+    This work is provided "as is" without warranty of any kind, either express or implied, including but not limited to the warranties of merchantability, fitness for a particular purpose, and noninfringement. In no event shall the authors or copyright holders be liable for any claim, damages, or other liability, whether in an action of contract, tort, or otherwise, arising from, out of, or in connection with the software or the use or other dealings in the software.
+
+Scope:
+
+    This license applies to both the hardware and software components of the DarkLight Cover Calibrator.
+
+Modified Versions:
+
+    You are permitted to create modified versions of the DarkLight Cover Calibrator for non-commercial use, provided that you:
+        Retain the original copyright notice and license terms.
+        Include a clear reference to the original creator (Nathan Woelfle) and provide a link to the original work.
+
+Jurisdiction:
+
+    This license is governed by the laws of the United States of America, and by international copyright laws and treaties.
+
+For more information, please refer to the full terms of the Creative Commons Attribution-NonCommercial 4.0 International License: https://creativecommons.org/licenses/by-nc/4.0/
+*******************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+//memory-mapped time series of heater telemetry snapshots
+//file layout: DarkLight_TelemetryHeader followed by capacity fixed-size records used as a ring,
+//head counts every record ever appended so record (head - 1) % capacity is the newest
+
+//bits of DarkLight_TelemetryRecord::validMask, a value the firmware reported as "na" is left clear
+enum DarkLight_TelemetryField : uint8_t
+{
+    TELEMETRY_HEATER1_TEMP = 0,
+    TELEMETRY_HEATER1_PWM,
+    TELEMETRY_HEATER2_TEMP,
+    TELEMETRY_HEATER2_PWM,
+    TELEMETRY_AMBIENT_TEMP,
+    TELEMETRY_HUMIDITY,
+    TELEMETRY_DEW_POINT,
+    TELEMETRY_FIELD_COUNT
+};
+
+struct DarkLight_TelemetryHeader
+{
+    char magic[8];        //"DLCTELEM"
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t capacity;    //records in the ring
+    uint64_t head;        //records appended since the file was created
+};
+
+struct DarkLight_TelemetryRecord
+{
+    uint64_t timeUs;      //wall clock, microseconds since the epoch
+    float values[TELEMETRY_FIELD_COUNT];
+    uint8_t validMask;
+    uint8_t heaterState;  //firmware 'R' code: 0 not present, 1 off, 2 auto, 3 on, 4 unknown, 5 error, 6 set
+    uint8_t reserved[2];
+};
+
+static_assert(sizeof(DarkLight_TelemetryRecord) == 40, "telemetry records must stay 40 bytes");
+static_assert(sizeof(DarkLight_TelemetryHeader) == 32, "telemetry header must stay 32 bytes");
+
+class DarkLight_TelemetryLog
+{
+    public:
+        static const uint32_t fileVersion = 1;
+        //about 24 days at the 2 s DHT22 interval, 40 MiB on disk
+        static const uint64_t defaultCapacity = 1 << 20;
+
+        DarkLight_TelemetryLog() = default;
+        ~DarkLight_TelemetryLog();
+        DarkLight_TelemetryLog(const DarkLight_TelemetryLog &) = delete;
+        DarkLight_TelemetryLog &operator=(const DarkLight_TelemetryLog &) = delete;
+
+        //map fileName, continuing an existing log or creating a new one of the given capacity in a missing or empty file
+        //a file that is not a telemetry log is left untouched and fails with errno EEXIST
+        bool open(const char *fileName, uint64_t capacity = defaultCapacity);
+        void close();
+        bool isOpen() const;
+        const std::string &getFileName() const;
+
+        //copy one snapshot into the ring, no formatting or system calls
+        void append(const DarkLight_TelemetryRecord &entry);
+
+    private:
+        std::string fileName;
+        void *map {nullptr};
+        size_t mapSize {0};
+        DarkLight_TelemetryHeader *header {nullptr};
+        DarkLight_TelemetryRecord *records {nullptr};
+};
@@ -0,0 +1,109 @@
+/*******************************************************************
+Creative Commons Attribution-NonCommercial License
+
+Copyright © 2020-2025 Nathan Woelfle
+
+This work is licensed under a Creative Commons Attribution-NonCommercial 4.0 International License.
+
+You are free to:
+
+    Share — copy and redistribute the material in any medium or format
+    Adapt — remix, transform, and build upon the material
+
+Under the following conditions:
+
+    Attribution — You must give appropriate credit, provide a link to the license, and indicate if changes were made. You may do so in any reasonable manner, but not in any way that suggests the licensor endorses you or your use.
+    NonCommercial — You may not use the material for commercial purposes.
+    No additional restrictions — You may not apply legal terms or technological measures that legally restrict others from doing anything the license permits.
+
+Notices:
+
+    You may not use this work for commercial purposes without written permission from the copyright holder.
+    This work is provided "as is" without warranty of any kind, either express or implied, including but not limited to the warranties of merchantability, fitness for a particular purpose, and noninfringement. In no event shall the authors or copyright holders be liable for any claim, damages, or other liability, whether in an action of contract, tort, or otherwise, arising from, out of, or in connection with the software or the use or other dealings in the software.
+
+Scope:
+
+    This license applies to both the hardware and software components of the DarkLight Cover Calibrator.
+
+Modified Versions:
+
+    You are permitted to create modified versions of the DarkLight Cover Calibrator for non-commercial use, provided that you:
+        Retain the original copyright notice and license terms.
+        Include a clear reference to the original creator (Nathan Woelfle) and provide a link to the original work.
+
+Jurisdiction:
+
+    This license is governed by the laws of the United States of America, and by international copyright laws and treaties.
+
+For more information, please refer to the full terms of the Creative Commons Attribution-NonCommercial 4.0 International License: https://creativecommons.org/licenses/by-nc/4.0/
+*******************************************************************/
+
+#include "darklight_trace.h"
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <algorithm>
+
+DarkLight_Trace::DarkLight_Trace(size_t capacity) : capacity(capacity)
+{
+}
+
+void DarkLight_Trace::setEnabled(bool value)
+{
+    //allocated before enabled is set, record() never sees an empty ring
+    if (value && records.empty())
+    {
+        records.resize(capacity);
+    }
+    enabled = value;
+}
+
+bool DarkLight_Trace::isEnabled() const
+{
+    return enabled;
+}
+
+void DarkLight_Trace::record(DarkLight_TraceType type, const char *data, size_t length)
+{
+    if (!enabled)
+    {
+        return;
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    DarkLight_TraceRecord &entry = records[head.fetch_add(1) % records.size()];
+    entry.timeUs = static_cast<uint64_t>(now.tv_sec) * 1000000 + now.tv_nsec / 1000;
+    entry.type = type;
+    entry.length = static_cast<uint8_t>(std::min(length, sizeof(entry.data)));
+    memcpy(entry.data, data, entry.length);
+}
+
+bool DarkLight_Trace::dump(const char *fileName) const
+{
+    FILE *fp = fopen(fileName, "wb");
+    if (fp == nullptr)
+    {
+        return false;
+    }
+
+    const uint64_t written = head;
+    const uint64_t count = std::min<uint64_t>(written, records.size());
+    const uint64_t first = written - count;
+
+    DarkLight_TraceHeader header;
+    memcpy(header.magic, "DLCTRACE", sizeof(header.magic));
+    header.version = fileVersion;
+    header.recordSize = sizeof(DarkLight_TraceRecord);
+    header.count = count;
+
+    bool ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+    for (uint64_t i = first; ok && i < written; i++)
+    {
+        ok = fwrite(&records[i % records.size()], sizeof(DarkLight_TraceRecord), 1, fp) == 1;
+    }
+
+    return (fclose(fp) == 0) && ok;
+}
@@ -0,0 +1,101 @@
+/*******************************************************************
+Creative Commons Attribution-NonCommercial License
+
+Copyright © 2020-2025 Nathan Woelfle
+
+This work is licensed under a Creative Commons Attribution-NonCommercial 4.0 International License.
+
+You are free to:
+
+    Share — copy and redistribute the material in any medium or format
+    Adapt — remix, transform, and build upon the material
+
+Under the following conditions:
+
+    Attribution — You must give appropriate credit, provide a link to the license, and indicate if changes were made. You may do so in any reasonable manner, but not in any way that suggests the licensor endorses you or your use.
+    NonCommercial — You may not use the material for commercial purposes.
+    No additional restrictions — You may not apply legal terms or technological measures that legally restrict others from doing anything the license permits.
+
+Notices:
+
+    You may not use this work for commercial purposes without written permission from the copyright holder.
+    This work is provided "as is" without warranty of any kind, either express or implied, including but not limited to the warranties of merchantability, fitness for a particular purpose, and noninfringement. In no event shall the authors or copyright holders be liable for any claim, damages, or other liability, whether in an action of contract, tort, or otherwise, arising from, out of, or in connection with the software or the use or other dealings in the software.
+
+Scope:
+
+    This license applies to both the hardware and software components of the DarkLight Cover Calibrator.
+
+Modified Versions:
+
+    You are permitted to create modified versions of the DarkLight Cover Calibrator for non-commercial use, provided that you:
+        Retain the original copyright notice and license terms.
+        Include a clear reference to the original creator (Nathan Woelfle) and provide a link to the original work.
+
+Jurisdiction:
+
+    This license is governed by the laws of the United States of America, and by international copyright laws and treaties.
+
+For more information, please refer to the full terms of the Creative Commons Attribution-NonCommercial 4.0 International License: https://creativecommons.org/licenses/by-nc/4.0/
+*******************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+//binary trace of serial traffic and state changes, kept in memory and dumped on request
+//the ring is allocated the first time tracing is enabled, a unit that never traces holds no records
+//file layout: DarkLight_TraceHeader followed by count records, oldest first
+
+enum DarkLight_TraceType : uint8_t
+{
+    TRACE_TX = 1,      //frame written to the port
+    TRACE_RX = 2,      //frame read from the port
+    TRACE_TIMEOUT = 3, //no reply within the timeout, data holds the command
+    TRACE_ERROR = 4,   //write/select/read error, data holds the command
+    TRACE_STATE = 5    //driver state change, data holds name=value
+};
+
+struct DarkLight_TraceHeader
+{
+    char magic[8];        //"DLCTRACE"
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t count;
+};
+
+struct DarkLight_TraceRecord
+{
+    uint64_t timeUs;      //wall clock, microseconds since the epoch
+    uint8_t type;
+    uint8_t length;       //bytes of data used
+    char data[22];
+};
+
+static_assert(sizeof(DarkLight_TraceRecord) == 32, "trace records must stay 32 bytes");
+
+class DarkLight_Trace
+{
+    public:
+        static const uint32_t fileVersion = 1;
+
+        explicit DarkLight_Trace(size_t capacity = 65536);
+
+        //enabling allocates the ring once, disabling keeps it so a later dump still has the records
+        void setEnabled(bool value);
+        bool isEnabled() const;
+
+        //copies at most sizeof(data) bytes, no formatting or allocation
+        void record(DarkLight_TraceType type, const char *data, size_t length);
+
+        //write the buffered records, oldest first
+        bool dump(const char *fileName) const;
+
+    private:
+        size_t capacity;
+        std::vector<DarkLight_TraceRecord> records;
+        std::atomic<uint64_t> head {0};
+        std::atomic<bool> enabled {false};
+};
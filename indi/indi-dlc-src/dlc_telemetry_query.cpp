@@ -0,0 +1,245 @@
+/*******************************************************************
+Creative Commons Attribution-NonCommercial License
+
+Copyright © 2020-2025 Nathan Woelfle
+
+This work is licensed under a Creative Commons Attribution-NonCommercial 4.0 International License.
+
+You are free to:
+
+    Share — copy and redistribute the material in any medium or format
+    Adapt — remix, transform, and build upon the material
+
+Under the following conditions:
+
+    Attribution — You must give appropriate credit, provide a link to the license, and indicate if changes were made. You may do so in any reasonable manner, but not in any way that suggests the licensor endorses you or your use.
+    NonCommercial — You may not use the material for commercial purposes.
+    No additional restrictions — You may not apply legal terms or technological measures that legally restrict others from doing anything the license permits.
+
+Notices:
+
+    You may not use this work for commercial purposes without written permission from the copyright holder.
+    This work is provided "as is" without warranty of any kind, either express or implied, including but not limited to the warranties of merchantability, fitness for a particular purpose, and noninfringement. In no event shall the authors or copyright holders be liable for any claim, damages, or other liability, whether in an action of contract, tort, or otherwise, arising from, out of, or in connection with the software or the use or other dealings in the software.
+
+Scope:
+
+    This license applies to both the hardware and software components of the DarkLight Cover Calibrator.
+
+Modified Versions:
+
+    You are permitted to create modified versions of the DarkLight Cover Calibrator for non-commercial use, provided that you:
+        Retain the original copyright notice and license terms.
+        Include a clear reference to the original creator (Nathan Woelfle) and provide a link to the original work.
+
+Jurisdiction:
+
+    This license is governed by the laws of the United States of America, and by international copyright laws and treaties.
+
+For more information, please refer to the full terms of the Creative Commons Attribution-NonCommercial 4.0 International License: https://creativecommons.org/licenses/by-nc/4.0/
+*******************************************************************/
+
+//downsamples a heater telemetry log written by the DarkLight Cover Calibrator driver to CSV
+//usage: dlc_telemetry_query <telemetry file> [bucket seconds] [last hours]
+//records are stamped with the wall clock, the last hours are counted back from the newest record
+//if the clock was stepped back while logging, the window is found by scanning back from the newest record
+//and stops at the step, and rows stay in the order they were recorded, so their times go back at the step
+
+#include "darklight_telemetry.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char *fieldNames[TELEMETRY_FIELD_COUNT] =
+{
+    "heater1_temp", "heater1_pwm", "heater2_temp", "heater2_pwm", "ambient_temp", "humidity", "dew_point"
+};
+
+//running sums for one output row
+struct Bucket
+{
+    uint64_t startUs {0};
+    uint32_t samples {0};
+    uint32_t counts[TELEMETRY_FIELD_COUNT] {0};
+    double sums[TELEMETRY_FIELD_COUNT] {0};
+    float maxPwm {0};
+    uint8_t lastState {0};
+};
+
+static void printBucket(const Bucket &bucket)
+{
+    time_t seconds = static_cast<time_t>(bucket.startUs / 1000000);
+    char timeStamp[32];
+    strftime(timeStamp, sizeof(timeStamp), "%Y-%m-%d %H:%M:%S", localtime(&seconds));
+
+    printf("%s,%u,%u", timeStamp, bucket.samples, bucket.lastState);
+    for (int i = 0; i < TELEMETRY_FIELD_COUNT; i++)
+    {
+        if (bucket.counts[i])
+        {
+            printf(",%.2f", bucket.sums[i] / bucket.counts[i]);
+        }
+        else
+        {
+            printf(",");
+        }
+    }
+    printf(",%.0f\n", bucket.maxPwm);
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <telemetry file> [bucket seconds] [last hours]\n", argv[0]);
+        return 1;
+    }
+
+    int fd = open(argv[1], O_RDONLY);
+    struct stat fileStat;
+    if (fd < 0 || fstat(fd, &fileStat) != 0)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+    if (static_cast<size_t>(fileStat.st_size) < sizeof(DarkLight_TelemetryHeader))
+    {
+        fprintf(stderr, "%s: not a DLC telemetry file\n", argv[1]);
+        close(fd);
+        return 1;
+    }
+
+    void *map = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+
+    const DarkLight_TelemetryHeader *header = static_cast<const DarkLight_TelemetryHeader *>(map);
+    if (memcmp(header->magic, "DLCTELEM", sizeof(header->magic)) != 0)
+    {
+        fprintf(stderr, "%s: not a DLC telemetry file\n", argv[1]);
+        munmap(map, fileStat.st_size);
+        return 1;
+    }
+    if (header->version != DarkLight_TelemetryLog::fileVersion || header->recordSize != sizeof(DarkLight_TelemetryRecord) ||
+            sizeof(DarkLight_TelemetryHeader) + header->capacity * sizeof(DarkLight_TelemetryRecord) >
+            static_cast<size_t>(fileStat.st_size))
+    {
+        fprintf(stderr, "%s: unsupported telemetry version %u\n", argv[1], header->version);
+        munmap(map, fileStat.st_size);
+        return 1;
+    }
+
+    const DarkLight_TelemetryRecord *records = reinterpret_cast<const DarkLight_TelemetryRecord *>(header + 1);
+    const uint64_t capacity = header->capacity;
+    const uint64_t written = __atomic_load_n(&header->head, __ATOMIC_ACQUIRE);
+    const uint64_t count = written < capacity ? written : capacity;
+    const uint64_t first = written - count;
+    if (count == 0)
+    {
+        munmap(map, fileStat.st_size);
+        return 0;
+    }
+
+    const uint64_t bucketUs = static_cast<uint64_t>((argc > 2 ? atof(argv[2]) : 300) * 1e6);
+
+    //records are in time order around the ring unless the wall clock (NTP, by hand) was stepped back while logging
+    bool ordered = true;
+    for (uint64_t i = first + 1; ordered && i < written; i++)
+    {
+        ordered = records[i % capacity].timeUs >= records[(i - 1) % capacity].timeUs;
+    }
+    if (!ordered)
+    {
+        fprintf(stderr, "%s: the clock went back while logging, rows are in recorded order\n", argv[1]);
+    }
+
+    //the window is the newest run of records stamped inside it, found by a binary search while the stamps are in order
+    uint64_t begin = first;
+    if (argc > 3)
+    {
+        const uint64_t lastUs = records[(written - 1) % capacity].timeUs;
+        const uint64_t windowUs = static_cast<uint64_t>(atof(argv[3]) * 3600e6);
+        const uint64_t startUs = lastUs > windowUs ? lastUs - windowUs : 0;
+        if (ordered)
+        {
+            uint64_t low = first, high = written;
+            while (low < high)
+            {
+                uint64_t middle = low + (high - low) / 2;
+                if (records[middle % capacity].timeUs < startUs)
+                {
+                    low = middle + 1;
+                }
+                else
+                {
+                    high = middle;
+                }
+            }
+            begin = low;
+        }
+        else
+        {
+            //walk back from the newest record, the window or a step back in the clock ends the run
+            begin = written;
+            while (begin > first && records[(begin - 1) % capacity].timeUs >= startUs &&
+                    (begin == written || records[(begin - 1) % capacity].timeUs <= records[begin % capacity].timeUs))
+            {
+                begin--;
+            }
+        }
+    }
+
+    printf("time,samples,heater_state");
+    for (const char *name : fieldNames)
+    {
+        printf(",%s", name);
+    }
+    printf(",max_pwm\n");
+
+    Bucket bucket;
+    for (uint64_t i = begin; i < written; i++)
+    {
+        const DarkLight_TelemetryRecord &entry = records[i % capacity];
+        const uint64_t bucketStartUs = bucketUs ? entry.timeUs - entry.timeUs % bucketUs : entry.timeUs;
+        if (bucket.samples && bucketStartUs != bucket.startUs)
+        {
+            printBucket(bucket);
+            bucket = Bucket();
+        }
+
+        bucket.startUs = bucketStartUs;
+        bucket.samples++;
+        bucket.lastState = entry.heaterState;
+        for (int field = 0; field < TELEMETRY_FIELD_COUNT; field++)
+        {
+            if (entry.validMask & (1 << field))
+            {
+                bucket.sums[field] += entry.values[field];
+                bucket.counts[field]++;
+            }
+        }
+        for (int field : {TELEMETRY_HEATER1_PWM, TELEMETRY_HEATER2_PWM})
+        {
+            if ((entry.validMask & (1 << field)) && entry.values[field] > bucket.maxPwm)
+            {
+                bucket.maxPwm = entry.values[field];
+            }
+        }
+    }
+    if (bucket.samples)
+    {
+        printBucket(bucket);
+    }
+
+    munmap(map, fileStat.st_size);
+    return 0;
+}
@@ -0,0 +1,145 @@
+/*******************************************************************
+Creative Commons Attribution-NonCommercial License
+
+Copyright © 2020-2025 Nathan Woelfle
+
+This work is licensed under a Creative Commons Attribution-NonCommercial 4.0 International License.
+
+You are free to:
+
+    Share — copy and redistribute the material in any medium or format
+    Adapt — remix, transform, and build upon the material
+
+Under the following conditions:
+
+    Attribution — You must give appropriate credit, provide a link to the license, and indicate if changes were made. You may do so in any reasonable manner, but not in any way that suggests the licensor endorses you or your use.
+    NonCommercial — You may not use the material for commercial purposes.
+    No additional restrictions — You may not apply legal terms or technological measures that legally restrict others from doing anything the license permits.
+
+Notices:
+
+    You may not use this work for commercial purposes without written permission from the copyright holder.
+    This work is provided "as is" without warranty of any kind, either express or implied, including but not limited to the warranties of merchantability, fitness for a particular purpose, and noninfringement. In no event shall the authors or copyright holders be liable for any claim, damages, or other liability, whether in an action of contract, tort, or otherwise, arising from, out of, or in connection with the software or the use or other dealings in the software.
+
+Scope:
+
+    This license applies to both the hardware and software components of the DarkLight Cover Calibrator.
+
+Modified Versions:
+
+    You are permitted to create modified versions of the DarkLight Cover Calibrator for non-commercial use, provided that you:
+        Retain the original copyright notice and license terms.
+        Include a clear reference to the original creator (Nathan Woelfle) and provide a link to the original work.
+
+Jurisdiction:
+
+    This license is governed by the laws of the United States of America, and by international copyright laws and treaties.
+
+For more information, please refer to the full terms of the Creative Commons Attribution-NonCommercial 4.0 International License: https://creativecommons.org/licenses/by-nc/4.0/
+*******************************************************************/
+
+//offline decoder for traces dumped by the DarkLight Cover Calibrator driver
+//usage: dlc_trace_decode <trace file> [last minutes]
+
+#include "darklight_trace.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+static const char *typeName(uint8_t type)
+{
+    switch (type)
+    {
+        case TRACE_TX:
+            return "TX";
+        case TRACE_RX:
+            return "RX";
+        case TRACE_TIMEOUT:
+            return "TIMEOUT";
+        case TRACE_ERROR:
+            return "ERROR";
+        case TRACE_STATE:
+            return "STATE";
+        default:
+            return "?";
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <trace file> [last minutes]\n", argv[0]);
+        return 1;
+    }
+
+    FILE *fp = fopen(argv[1], "rb");
+    if (fp == nullptr)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+
+    DarkLight_TraceHeader header;
+    if (fread(&header, sizeof(header), 1, fp) != 1 || memcmp(header.magic, "DLCTRACE", sizeof(header.magic)) != 0)
+    {
+        fprintf(stderr, "%s: not a DLC trace file\n", argv[1]);
+        fclose(fp);
+        return 1;
+    }
+    if (header.version != DarkLight_Trace::fileVersion || header.recordSize != sizeof(DarkLight_TraceRecord))
+    {
+        fprintf(stderr, "%s: unsupported trace version %u\n", argv[1], header.version);
+        fclose(fp);
+        return 1;
+    }
+
+    std::vector<DarkLight_TraceRecord> records(header.count);
+    records.resize(fread(records.data(), sizeof(DarkLight_TraceRecord), header.count, fp));
+    fclose(fp);
+    if (records.empty())
+    {
+        return 0;
+    }
+
+    //optionally keep only the last N minutes before the final record
+    uint64_t startUs = 0;
+    if (argc > 2)
+    {
+        startUs = records.back().timeUs - static_cast<uint64_t>(atof(argv[2]) * 60e6);
+    }
+
+    //timeline: wall time, gap to the previous record, round trip of RX to its TX
+    uint64_t previousUs = 0, lastTxUs = 0;
+    for (const DarkLight_TraceRecord &entry : records)
+    {
+        if (entry.timeUs < startUs)
+        {
+            continue;
+        }
+
+        time_t seconds = static_cast<time_t>(entry.timeUs / 1000000);
+        char timeStamp[32];
+        strftime(timeStamp, sizeof(timeStamp), "%Y-%m-%d %H:%M:%S", localtime(&seconds));
+
+        double gapMs = previousUs ? (entry.timeUs - previousUs) / 1000.0 : 0;
+        printf("%s.%06u  +%10.3f ms  %-7s  %.*s", timeStamp, static_cast<unsigned>(entry.timeUs % 1000000), gapMs,
+               typeName(entry.type), entry.length, entry.data);
+
+        if (entry.type == TRACE_TX)
+        {
+            lastTxUs = entry.timeUs;
+        }
+        else if ((entry.type == TRACE_RX || entry.type == TRACE_TIMEOUT) && lastTxUs)
+        {
+            printf("  (%.3f ms)", (entry.timeUs - lastTxUs) / 1000.0);
+        }
+        printf("\n");
+        previousUs = entry.timeUs;
+    }
+
+    return 0;
+}
@@ -0,0 +1,116 @@
+/*******************************************************************
+Creative Commons Attribution-NonCommercial License
+
+Copyright © 2020-2025 Nathan Woelfle
+
+This work is licensed under a Creative Commons Attribution-NonCommercial 4.0 International License.
+
+You are free to:
+
+    Share — copy and redistribute the material in any medium or format
+    Adapt — remix, transform, and build upon the material
+
+Under the following conditions:
+
+    Attribution — You must give appropriate credit, provide a link to the license, and indicate if changes were made. You may do so in any reasonable manner, but not in any way that suggests the licensor endorses you or your use.
+    NonCommercial — You may not use the material for commercial purposes.
+    No additional restrictions — You may not apply legal terms or technological measures that legally restrict others from doing anything the license permits.
+
+Notices:
+
+    You may not use this work for commercial purposes without written permission from the copyright holder.
+    This work is provided "as is" without warranty of any kind, either express or implied, including but not limited to the warranties of merchantability, fitness for a particular purpose, and noninfringement. In no event shall the authors or copyright holders be liable for any claim, damages, or other liability, whether in an action of contract, tort, or otherwise, arising from, out of, or in connection with the software or the use or other dealings in the software.
+
+Scope:
+
+    This license applies to both the hardware and software components of the DarkLight Cover Calibrator.
+
+Modified Versions:
+
+    You are permitted to create modified versions of the DarkLight Cover Calibrator for non-commercial use, provided that you:
+        Retain the original copyright notice and license terms.
+        Include a clear reference to the original creator (Nathan Woelfle) and provide a link to the original work.
+
+Jurisdiction:
+
+    This license is governed by the laws of the United States of America, and by international copyright laws and treaties.
+
+For more information, please refer to the full terms of the Creative Commons Attribution-NonCommercial 4.0 International License: https://creativecommons.org/licenses/by-nc/4.0/
+*******************************************************************/
+
+#pragma once
+
+#include "Arduino.h"
+
+//simulated ATmega328P EEPROM for the host checks, every access is counted with the CPU cycles it costs at 16 MHz
+//a write-only or erase-only operation is the EEPROMWearLevel control byte programming, see EEPROMWearLevelHost.cpp
+
+struct EEPROMSimulation
+{
+    uint8_t cells[1024];
+    unsigned long reads;
+    unsigned long eraseWrites;     //EEPROM.update()/put() of a changed byte
+    unsigned long writeOnly;       //bits programmed to 0 without an erase
+    unsigned long eraseOnly;       //byte cleared to 0xFF
+    unsigned long long cycles;
+
+    void resetCounters()
+    {
+        reads = eraseWrites = writeOnly = eraseOnly = 0;
+        cycles = 0;
+    }
+};
+
+extern EEPROMSimulation eepromSimulation;
+
+const unsigned long long eepromReadCycles = 12;           //eeprom_read_byte() including the 4 cycle halt
+const unsigned long long eepromEraseWriteCycles = 54400;  //3.4 ms atomic erase and write
+const unsigned long long eepromSplitCycles = 28800;       //1.8 ms write-only or erase-only
+
+class EEPROMClass
+{
+    public:
+        uint8_t read(int index)
+        {
+            eepromSimulation.reads++;
+            eepromSimulation.cycles += eepromReadCycles;
+            return eepromSimulation.cells[index];
+        }
+
+        void update(int index, uint8_t value)
+        {
+            if (read(index) != value)
+            {
+                eepromSimulation.eraseWrites++;
+                eepromSimulation.cycles += eepromEraseWriteCycles;
+                eepromSimulation.cells[index] = value;
+            }
+        }
+
+        uint16_t length()
+        {
+            return sizeof(eepromSimulation.cells);
+        }
+
+        template <typename T> T &get(int index, T &t)
+        {
+            uint8_t *bytes = (uint8_t *)&t;
+            for (size_t i = 0; i < sizeof(T); i++)
+            {
+                bytes[i] = read(index + i);
+            }
+            return t;
+        }
+
+        template <typename T> const T &put(int index, const T &t)
+        {
+            const uint8_t *bytes = (const uint8_t *)&t;
+            for (size_t i = 0; i < sizeof(T); i++)
+            {
+                update(index + i, bytes[i]);
+            }
+            return t;
+        }
+};
+
+extern EEPROMClass EEPROM;
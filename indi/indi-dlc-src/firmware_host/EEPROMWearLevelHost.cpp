@@ -0,0 +1,63 @@
+/*******************************************************************
+Creative Commons Attribution-NonCommercial License
+
+Copyright © 2020-2025 Nathan Woelfle
+
+This work is licensed under a Creative Commons Attribution-NonCommercial 4.0 International License.
+
+You are free to:
+
+    Share — copy and redistribute the material in any medium or format
+    Adapt — remix, transform, and build upon the material
+
+Under the following conditions:
+
+    Attribution — You must give appropriate credit, provide a link to the license, and indicate if changes were made. You may do so in any reasonable manner, but not in any way that suggests the licensor endorses you or your use.
+    NonCommercial — You may not use the material for commercial purposes.
+    No additional restrictions — You may not apply legal terms or technological measures that legally restrict others from doing anything the license permits.
+
+Notices:
+
+    You may not use this work for commercial purposes without written permission from the copyright holder.
+    This work is provided "as is" without warranty of any kind, either express or implied, including but not limited to the warranties of merchantability, fitness for a particular purpose, and noninfringement. In no event shall the authors or copyright holders be liable for any claim, damages, or other liability, whether in an action of contract, tort, or otherwise, arising from, out of, or in connection with the software or the use or other dealings in the software.
+
+Scope:
+
+    This license applies to both the hardware and software components of the DarkLight Cover Calibrator.
+
+Modified Versions:
+
+    You are permitted to create modified versions of the DarkLight Cover Calibrator for non-commercial use, provided that you:
+        Retain the original copyright notice and license terms.
+        Include a clear reference to the original creator (Nathan Woelfle) and provide a link to the original work.
+
+Jurisdiction:
+
+    This license is governed by the laws of the United States of America, and by international copyright laws and treaties.
+
+For more information, please refer to the full terms of the Creative Commons Attribution-NonCommercial 4.0 International License: https://creativecommons.org/licenses/by-nc/4.0/
+*******************************************************************/
+
+//the host platform of EEPROMWearLevel, like src/avr and src/megaavr it supplies the control byte
+//programming, here against the simulated EEPROM in EEPROM.h
+
+#include <Arduino.h>
+#include "EEPROMWearLevel.h"
+
+EEPROMSimulation eepromSimulation;
+EEPROMClass EEPROM;
+Print Serial;
+
+void EEPROMWearLevel::programZeroBitsToZero(int index, byte byteWithZeros)
+{
+    eepromSimulation.writeOnly++;
+    eepromSimulation.cycles += eepromSplitCycles;
+    eepromSimulation.cells[index] &= byteWithZeros;
+}
+
+void EEPROMWearLevel::clearByteToOnes(int index)
+{
+    eepromSimulation.eraseOnly++;
+    eepromSimulation.cycles += eepromSplitCycles;
+    eepromSimulation.cells[index] = 0xFF;
+}
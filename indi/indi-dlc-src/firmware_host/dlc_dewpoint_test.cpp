@@ -0,0 +1,85 @@
+/*******************************************************************
+Creative Commons Attribution-NonCommercial License
+
+Copyright © 2020-2025 Nathan Woelfle
+
+This work is licensed under a Creative Commons Attribution-NonCommercial 4.0 International License.
+
+You are free to:
+
+    Share — copy and redistribute the material in any medium or format
+    Adapt — remix, transform, and build upon the material
+
+Under the following conditions:
+
+    Attribution — You must give appropriate credit, provide a link to the license, and indicate if changes were made. You may do so in any reasonable manner, but not in any way that suggests the licensor endorses you or your use.
+    NonCommercial — You may not use the material for commercial purposes.
+    No additional restrictions — You may not apply legal terms or technological measures that legally restrict others from doing anything the license permits.
+
+Notices:
+
+    You may not use this work for commercial purposes without written permission from the copyright holder.
+    This work is provided "as is" without warranty of any kind, either express or implied, including but not limited to the warranties of merchantability, fitness for a particular purpose, and noninfringement. In no event shall the authors or copyright holders be liable for any claim, damages, or other liability, whether in an action of contract, tort, or otherwise, arising from, out of, or in connection with the software or the use or other dealings in the software.
+
+Scope:
+
+    This license applies to both the hardware and software components of the DarkLight Cover Calibrator.
+
+Modified Versions:
+
+    You are permitted to create modified versions of the DarkLight Cover Calibrator for non-commercial use, provided that you:
+        Retain the original copyright notice and license terms.
+        Include a clear reference to the original creator (Nathan Woelfle) and provide a link to the original work.
+
+Jurisdiction:
+
+    This license is governed by the laws of the United States of America, and by international copyright laws and treaties.
+
+For more information, please refer to the full terms of the Creative Commons Attribution-NonCommercial 4.0 International License: https://creativecommons.org/licenses/by-nc/4.0/
+*******************************************************************/
+
+
+//checks the firmware's fixed-point dew point against the float August-Roche-Magnus formula
+//over the outside sensor's range, fails if any point is off by more than maxError
+
+#include "dew_point.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+static const double maxError = 0.02; //(degrees)
+
+//what the firmware computed with float log() before it went to fixed point, 0% is read as 0.01% there too
+static double referenceDewPoint(double temp, double humidity)
+{
+    double gamma = 17.27 * temp / (237.7 + temp) + log(std::max(humidity, 0.01) / 100.0);
+    return 237.7 * gamma / (17.27 - gamma);
+}
+
+int main()
+{
+    double worstError = 0;
+    int worstTemp = 0, worstHumidity = 0;
+    long points = 0;
+
+    //-40 to 85 C and 0 to 100 %RH, the steps are odd so every table interval and rounding case is hit
+    for (int temp = -4000; temp <= 8500; temp += 7)
+    {
+        for (int humidity = 0; humidity <= 10000; humidity += 3)
+        {
+            double error = fabs(calculateDewPoint(temp, humidity) / 100.0 - referenceDewPoint(temp / 100.0, humidity / 100.0));
+            if (error > worstError)
+            {
+                worstError = error;
+                worstTemp = temp;
+                worstHumidity = humidity;
+            }
+            points++;
+        }
+    }
+
+    printf("%ld points, max error %.4f C at %.2f C %.2f %%RH (limit %.2f C)\n", points, worstError, worstTemp / 100.0,
+           worstHumidity / 100.0, maxError);
+    return worstError <= maxError ? 0 : 1;
+}
@@ -0,0 +1,145 @@
+/*******************************************************************
+Creative Commons Attribution-NonCommercial License
+
+Copyright © 2020-2025 Nathan Woelfle
+
+This work is licensed under a Creative Commons Attribution-NonCommercial 4.0 International License.
+
+You are free to:
+
+    Share — copy and redistribute the material in any medium or format
+    Adapt — remix, transform, and build upon the material
+
+Under the following conditions:
+
+    Attribution — You must give appropriate credit, provide a link to the license, and indicate if changes were made. You may do so in any reasonable manner, but not in any way that suggests the licensor endorses you or your use.
+    NonCommercial — You may not use the material for commercial purposes.
+    No additional restrictions — You may not apply legal terms or technological measures that legally restrict others from doing anything the license permits.
+
+Notices:
+
+    You may not use this work for commercial purposes without written permission from the copyright holder.
+    This work is provided "as is" without warranty of any kind, either express or implied, including but not limited to the warranties of merchantability, fitness for a particular purpose, and noninfringement. In no event shall the authors or copyright holders be liable for any claim, damages, or other liability, whether in an action of contract, tort, or otherwise, arising from, out of, or in connection with the software or the use or other dealings in the software.
+
+Scope:
+
+    This license applies to both the hardware and software components of the DarkLight Cover Calibrator.
+
+Modified Versions:
+
+    You are permitted to create modified versions of the DarkLight Cover Calibrator for non-commercial use, provided that you:
+        Retain the original copyright notice and license terms.
+        Include a clear reference to the original creator (Nathan Woelfle) and provide a link to the original work.
+
+Jurisdiction:
+
+    This license is governed by the laws of the United States of America, and by international copyright laws and treaties.
+
+For more information, please refer to the full terms of the Creative Commons Attribution-NonCommercial 4.0 International License: https://creativecommons.org/licenses/by-nc/4.0/
+*******************************************************************/
+
+//benchmarks EEPROMWearLevel put() on the simulated EEPROM, built once with the RAM copy of each value
+//and once with NO_RAM_SHADOW, fails if a put() of an unchanged value costs other than expected
+//or if the values don't come back through a fresh begin()
+
+#include <Arduino.h>
+#include "EEPROMWearLevel.h"
+
+#include <cstdio>
+
+static const int putCount = 10000;
+
+struct Gains
+{
+    int16_t kp, ki, kff;
+};
+
+static void report(const char *name)
+{
+    printf("%-22s reads/put %6.2f  data writes/put %5.2f  ctrl writes/put %5.2f  clears/put %5.3f  cycles/put %9.1f\n", name,
+           eepromSimulation.reads / (double)putCount, eepromSimulation.eraseWrites / (double)putCount,
+           eepromSimulation.writeOnly / (double)putCount, eepromSimulation.eraseOnly / (double)putCount,
+           eepromSimulation.cycles / (double)putCount);
+}
+
+//an unchanged put() reads nothing with the RAM copy and compares every byte in EEPROM without it
+static bool checkUnchanged(const char *name, int dataLength)
+{
+#ifndef NO_RAM_SHADOW
+    const unsigned long expectedReads = 0;
+    (void)dataLength;
+#else
+    const unsigned long expectedReads = (unsigned long)dataLength * putCount;
+#endif
+    report(name);
+    if (eepromSimulation.reads != expectedReads || eepromSimulation.eraseWrites || eepromSimulation.writeOnly ||
+            eepromSimulation.eraseOnly)
+    {
+        printf("%s: expected %lu reads and no writes\n", name, expectedReads);
+        return false;
+    }
+    return true;
+}
+
+int main()
+{
+    bool ok = true;
+    memset(eepromSimulation.cells, 0xFF, sizeof(eepromSimulation.cells));
+
+#ifndef NO_RAM_SHADOW
+    printf("RAM copy of each value\n");
+#else
+    printf("NO_RAM_SHADOW\n");
+#endif
+
+    EEPROMwl.begin(4, 9, 1023);
+    uint8_t value = 7;
+    Gains gains = {12, 3, 40};
+    EEPROMwl.put(0, value);
+    EEPROMwl.put(6, gains);
+
+    eepromSimulation.resetCounters();
+    for (int i = 0; i < putCount; i++)
+    {
+        EEPROMwl.put(0, value);
+    }
+    ok = checkUnchanged("uint8 unchanged", sizeof(value)) && ok;
+
+    eepromSimulation.resetCounters();
+    for (int i = 0; i < putCount; i++)
+    {
+        EEPROMwl.put(6, gains);
+    }
+    ok = checkUnchanged("gains (6 B) unchanged", sizeof(gains)) && ok;
+
+    eepromSimulation.resetCounters();
+    for (int i = 0; i < putCount; i++)
+    {
+        value = i & 0xFF;
+        EEPROMwl.put(0, value);
+    }
+    report("uint8 changed");
+
+    eepromSimulation.resetCounters();
+    for (int i = 0; i < putCount; i++)
+    {
+        gains.kp = i;
+        EEPROMwl.put(6, gains);
+    }
+    report("gains (6 B) changed");
+
+    //read back like after a reboot
+    uint8_t reloadedValue = 0;
+    Gains reloadedGains = {0, 0, 0};
+    EEPROMWearLevel reloaded;
+    reloaded.begin(4, 9, 1023);
+    reloaded.get(0, reloadedValue);
+    reloaded.get(6, reloadedGains);
+    if (reloadedValue != value || memcmp(&reloadedGains, &gains, sizeof(gains)) != 0)
+    {
+        printf("values read back after begin() don't match\n");
+        ok = false;
+    }
+
+    return ok ? 0 : 1;
+}